@@ -0,0 +1,85 @@
+#include "file_buffer.h"
+
+#include <fstream>
+#include <istream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FILE_BUFFER_USE_MMAP 1
+#endif
+
+namespace file {
+    CFileBuffer::~CFileBuffer() {
+        close();
+    }
+
+    bool CFileBuffer::open(const std::string& file_path) {
+        close();
+#ifdef FILE_BUFFER_USE_MMAP
+        const int fd = ::open(file_path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ == 0) {
+            ::close(fd);
+            return true;
+        }
+        void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (addr != MAP_FAILED) {
+            ::madvise(addr, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(addr);
+            mapped_ = true;
+            return true;
+        }
+        size_ = 0;
+#endif
+        std::ifstream in(file_path, std::ios::binary | std::ios::ate);
+        if (!in.is_open()) return false;
+        storage_.resize(static_cast<size_t>(in.tellg()));
+        in.seekg(0);
+        if (!in.read(storage_.data(), storage_.size())) {
+            storage_.clear();
+            return false;
+        }
+        data_ = storage_.data();
+        size_ = storage_.size();
+        return true;
+    }
+
+    bool CFileBuffer::open(std::istream& in) {
+        close();
+        constexpr size_t kChunk = size_t(1) << 20;
+        size_t used = 0;
+        while (in) {
+            storage_.resize(used + kChunk);
+            in.read(storage_.data() + used, kChunk);
+            used += static_cast<size_t>(in.gcount());
+        }
+        if (in.bad()) {
+            storage_.clear();
+            return false;
+        }
+        storage_.resize(used);
+        data_ = storage_.data();
+        size_ = storage_.size();
+        return true;
+    }
+
+    void CFileBuffer::close() {
+#ifdef FILE_BUFFER_USE_MMAP
+        if (mapped_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+        mapped_ = false;
+        data_ = nullptr;
+        size_ = 0;
+        storage_.clear();
+    }
+}
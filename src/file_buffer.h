@@ -0,0 +1,42 @@
+#ifndef FILE_BUFFER_H_
+#define FILE_BUFFER_H_
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace file {
+	// read-only view of a whole file: memory mapped where the platform allows it,
+	// otherwise read in a single bulk call
+	class CFileBuffer {
+	public:
+		explicit CFileBuffer() = default;
+		~CFileBuffer();
+
+		CFileBuffer(const CFileBuffer&) = delete;
+		CFileBuffer& operator=(const CFileBuffer&) = delete;
+
+		bool open(const std::string& file_path);
+		// reads in until end of stream (pipes included) into owned storage
+		bool open(std::istream& in);
+		void close();
+
+		const char* data() const { return data_; }
+		size_t size() const { return size_; }
+
+	private:
+		const char* data_ = nullptr;
+		size_t size_ = 0;
+		bool mapped_ = false;
+		std::vector<char> storage_;
+	};
+
+	// binary formats are stored little endian and written straight from memory
+	inline bool IsLittleEndianHost() {
+		const unsigned short probe = 1;
+		return *reinterpret_cast<const unsigned char*>(&probe) == 1;
+	}
+}
+
+#endif // FILE_BUFFER_H_
@@ -1,14 +1,33 @@
 ﻿#include "mesh/mesh.h"
 #include "mesh/transform.h"
+#include "mesh_file.h"
+#include "mesh_server.h"
 #include "obj_file.h"
+#include "quantized_file.h"
+#include "result_cache.h"
+#include "transform_options.h"
 
+#include <cstdint>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <memory>
 #include <string>
 #include <vector>
 #include <cmath>
+#include <stdexcept>
+#include <streambuf>
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#ifdef _MSC_VER
 #include <corecrt_math_defines.h>
+#endif
 
 namespace mesh_app {
 
@@ -17,7 +36,11 @@ namespace mesh_app {
     using linear_algebra::Vector3;
 
     void PrintUsage(const std::string& excutable_name) {
-        std::cout << "Usage: "<< excutable_name<<" <input.obj> <output.obj> [options]\n\n"
+        std::cout << "Usage: "<< excutable_name<<" <input> <output> [options]\n\n"
+            << "Formats (by extension): .obj, .ply (binary little endian), .stl (binary),\n"
+            << "                        .qmesh (quantized, chunked, parallel decode)\n"
+            << "<input> / <output> may be - for stdin / stdout (OBJ, or the input format, unless\n"
+            << "--input-format / --output-format say otherwise); status then goes to stderr\n\n"
             << "Options (order matters):\n"
             << "  --translate tx ty tz\n"
             << "  --scale s\n"
@@ -27,18 +50,39 @@ namespace mesh_app {
             << "  --rotate-z angle_deg\n"
             << "  --rotate-axis ax ay az angle_deg\n"
             << "  --shear sxy sxz syx syz szx szy\n"
+            << "  --group <name>     apply the following transforms only to OBJ o/g group <name>\n"
+            << "  --all              apply the following transforms to the whole mesh again\n"
+            << "  --optimize-order   reorder faces/vertices for GPU vertex cache and fetch locality\n"
+            << "  --decimate <ratio|count> [max-mb]  quadric edge-collapse simplification to a fraction\n"
+            << "                     (<= 1) or an absolute triangle count (> 1); max-mb caps the working\n"
+            << "                     memory by simplifying the faces in runs (run borders are kept)\n"
+            << "  --weld [eps]       merge vertices closer than eps (default 0: identical positions)\n"
+            << "  --recompute-normals  smooth area weighted vertex normals\n"
+            << "  --write <path>     write the mesh as it is at this point of the chain\n"
+            << "                     (- for stdout; status then goes to stderr)\n"
+            << "  --quant-bits n     position bit depth for .qmesh output (1-30, default 16)\n"
+            << "  --input-format f   obj, ply, stl or qmesh; needed for non-OBJ stdin\n"
+            << "  --output-format f  format written to stdout\n"
             << "  --log <path>       specify custom log file path\n"
+            << "  --log-fd n         write the log to file descriptor n (POSIX)\n"
+            << "  --cache-dir <dir>  reuse the output of an identical earlier run (same input bytes\n"
+            << "                     and job); file input and output only\n"
+            << "  --cache-max-mb n   size bound of --cache-dir, oldest results evicted (default 1024)\n"
             << "  --verbose [0|1]    print transformations to stdout (default=1)\n"
             << "  --help\n\n"
+            << "Mesh operations (--weld, --recompute-normals, --decimate, --optimize-order,\n"
+            << "--write) run in place, after every transform given before them.\n\n"
+            << "Server mode (POSIX):\n"
+            << "  " << excutable_name << " --serve <unix-socket> [--workers n] [--cache-mb m]\n"
+            << "  one JSON request per line, e.g.\n"
+            << "  {\"id\": 1, \"input\": \"a.obj\", \"output\": \"b.ply\", \"ops\": [\"--scale\", 2]}\n"
+            << "  {\"cmd\": \"stats\"}  {\"cmd\": \"shutdown\"}\n\n"
             << "Example:\n"
             << excutable_name<<" input.obj output.obj "
             "--translate 1 2 3 --rotate-z 45 --scale 2 "
             "--log transform.log --verbose 0\n";
     }
 
-    // degrees → radians
-    inline double DegToRad(double deg) { return deg * M_PI / 180.0; }
-
     void PrintMatrix(std::ostream& os, const linear_algebra::Matrix4x4& m) {
         auto data = m.data();
         os << std::fixed << std::setprecision(4);
@@ -61,6 +105,58 @@ namespace mesh_app {
         return path + ".log";
     }
 
+#ifndef _WIN32
+    // buffered output straight to an inherited descriptor with write(2): appends where
+    // the descriptor points (e.g. 3>>run.log) and leaves it open
+    class FdStreambuf : public std::streambuf {
+    public:
+        explicit FdStreambuf(int fd) : fd_(fd) {
+            setp(buffer_, buffer_ + sizeof(buffer_));
+        }
+        ~FdStreambuf() override {
+            sync();
+        }
+
+    protected:
+        int_type overflow(int_type ch) override {
+            if (!flush_buffer()) return traits_type::eof();
+            if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(ch);
+                pbump(1);
+            }
+            return traits_type::not_eof(ch);
+        }
+
+        int sync() override {
+            return flush_buffer() ? 0 : -1;
+        }
+
+    private:
+        bool flush_buffer() {
+            const char* data = pbase();
+            while (data < pptr()) {
+                const ssize_t written = ::write(fd_, data, static_cast<size_t>(pptr() - data));
+                if (written < 0 && errno == EINTR) continue;
+                if (written <= 0) return false;
+                data += written;
+            }
+            setp(buffer_, buffer_ + sizeof(buffer_));
+            return true;
+        }
+
+        int fd_;
+        char buffer_[4096];
+    };
+#endif
+
+    void PrintCodecStats(std::ostream& os, const char* label, const file::CodecStats& stats) {
+        const double mb = stats.raw_bytes_ / (1024.0 * 1024.0);
+        os << std::fixed << std::setprecision(2)
+            << "  " << label << ": " << stats.raw_bytes_ << " raw bytes <-> " << stats.encoded_bytes_
+            << " encoded bytes, ratio " << (stats.encoded_bytes_ ? double(stats.raw_bytes_) / stats.encoded_bytes_ : 0.0)
+            << ":1, " << (stats.seconds_ > 0 ? mb / stats.seconds_ : 0.0) << " MB/s\n";
+    }
+
 }  // namespace mesh_app
 
 int main(int argc, char** argv) {
@@ -68,6 +164,31 @@ int main(int argc, char** argv) {
     using namespace mesh;
     std::string filename;
     file::CObjFile objfile;
+    if (argc >= 3 && std::string(argv[1]) == "--serve") {
+        ServerOptions options;
+        options.socket_path_ = argv[2];
+        for (int i = 3; i < argc; ++i) {
+            std::string arg = argv[i];
+            try {
+                if (arg == "--workers" && i + 1 < argc) {
+                    options.workers_ = std::stoi(argv[++i]);
+                }
+                else if (arg == "--cache-mb" && i + 1 < argc) {
+                    options.cache_budget_bytes_ = static_cast<size_t>(std::stoull(argv[++i])) << 20;
+                }
+                else {
+                    std::cerr << "\n⚠️ Unknown or malformed option: " << arg << "\n";
+                    PrintUsage(filename);
+                    return 1;
+                }
+            }
+            catch (const std::exception& e) {
+                std::cerr << "❌ Error parsing option " << arg << ": " << e.what() << "\n";
+                return 1;
+            }
+        }
+        return RunServer(options);
+    }
     if (argc < 3) {
         if (argc >= 1) {
             std::string fullPath = argv[0];
@@ -93,7 +214,20 @@ int main(int argc, char** argv) {
 
     std::string input_path = argv[1];
     std::string output_path = argv[2];
-    std::string log_path = GetDefaultLogPath(output_path);
+    // "-" streams the mesh through stdin / stdout; status then goes to stderr and the
+    // log only to an explicit --log / --log-fd
+    const bool stream_in = input_path == "-";
+    const bool stream_out = output_path == "-";
+    // an intermediate "--write -" owns stdout as well, so status moves to stderr for it too
+    bool status_to_stderr = stream_out;
+    for (int i = 3; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--write" && std::string(argv[i + 1]) == "-") status_to_stderr = true;
+    }
+    std::string log_path = stream_out ? std::string() : GetDefaultLogPath(output_path);
+    std::string input_format_name, output_format_name;
+    std::string cache_dir;
+    uint64_t cache_max_mb = 1024;
+    int log_fd = -1;  // --log-fd, used instead of log_path
     bool verbose = true;  // 默认输出到 stdout
 
     // 预扫描命令行：提取 --log 和 --verbose 参数
@@ -101,6 +235,38 @@ int main(int argc, char** argv) {
         std::string arg = argv[i];
         if (arg == "--log") {
             log_path = argv[i + 1];
+            log_fd = -1;
+        }
+        else if (arg == "--log-fd") {
+            try {
+                log_fd = std::stoi(argv[i + 1]);
+            }
+            catch (const std::exception&) {
+                log_fd = -1;
+            }
+            if (log_fd < 0) {
+                std::cerr << "❌ Error parsing option --log-fd: " << argv[i + 1] << "\n";
+                return 1;
+            }
+            log_path = std::string("fd ") + argv[i + 1];
+        }
+        else if (arg == "--input-format") {
+            input_format_name = argv[i + 1];
+        }
+        else if (arg == "--output-format") {
+            output_format_name = argv[i + 1];
+        }
+        else if (arg == "--cache-dir") {
+            cache_dir = argv[i + 1];
+        }
+        else if (arg == "--cache-max-mb") {
+            try {
+                cache_max_mb = std::stoull(argv[i + 1]);
+            }
+            catch (const std::exception&) {
+                std::cerr << "❌ Error parsing option --cache-max-mb: " << argv[i + 1] << "\n";
+                return 1;
+            }
         }
         else if (arg == "--verbose") {
             std::string val = argv[i + 1];
@@ -111,150 +277,237 @@ int main(int argc, char** argv) {
         }
     }
 
-    std::ofstream log_file(log_path);
-    if (!log_file.is_open()) {
-        std::cerr << "❌ Error: failed to create log file: " << log_path << "\n";
+    if (stream_in || stream_out) {
+        std::ios::sync_with_stdio(false);
+#ifdef _WIN32
+        _setmode(_fileno(stdin), _O_BINARY);
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    }
+
+    std::ofstream log_stream;
+    std::unique_ptr<std::streambuf> log_fd_buffer;
+    std::ostream fd_log(nullptr);
+    std::ostream null_log(nullptr);
+    if (log_fd >= 0) {
+#ifdef _WIN32
+        std::cerr << "❌ Error: --log-fd is not supported on Windows\n";
         return 1;
+#else
+        if (fcntl(log_fd, F_GETFL) == -1) {
+            std::cerr << "❌ Error: log file descriptor is not open: " << log_fd << "\n";
+            return 1;
+        }
+        log_fd_buffer = std::make_unique<FdStreambuf>(log_fd);
+        fd_log.rdbuf(log_fd_buffer.get());
+#endif
+    }
+    else if (!log_path.empty()) {
+        log_stream.open(log_path);
+        if (!log_stream.is_open()) {
+            std::cerr << "❌ Error: failed to create log file: " << log_path << "\n";
+            return 1;
+        }
     }
+    std::ostream& log_file = log_fd >= 0 ? fd_log : log_path.empty() ? null_log : log_stream;
 
     //std::ostream& os = verbose ? std::cout : *(new std::ostringstream);
-    std::ostream& os = std::cout;
+    std::ostream& os = status_to_stderr ? std::cerr : std::cout;
 
     log_file << "=== Mesh Transformation Log ===\n";
     log_file << "Input file: " << input_path << "\n";
     log_file << "Output file: " << output_path << "\n";
     log_file << "Verbose: " << (verbose ? "true" : "false") << "\n\n";
 
-    std::shared_ptr<file::CObjFile> obj_file = std::make_shared<file::CObjFile>();
-    if (!obj_file->read(input_path)) {
+    // stdin defaults to OBJ, stdout to the input format
+    const file::MeshFormat input_format = !input_format_name.empty() ? file::FormatFromName(input_format_name)
+        : stream_in ? file::MeshFormat::kObj : file::FormatFromPath(input_path);
+    const file::MeshFormat output_format = !output_format_name.empty() ? file::FormatFromName(output_format_name)
+        : stream_out ? input_format : file::FormatFromPath(output_path);
+    if (input_format == file::MeshFormat::kUnknown || output_format == file::MeshFormat::kUnknown) {
+        std::cerr << "❌ Error: unsupported file extension (expected .obj, .ply, .stl or .qmesh)\n";
+        log_file << "❌ Unsupported file extension\n";
+        return 1;
+    }
+
+    // options that do not change the output bytes, each followed by one value
+    auto is_run_option = [](const std::string& arg) {
+        return arg == "--log" || arg == "--log-fd" || arg == "--verbose" || arg == "--input-format" ||
+            arg == "--output-format" || arg == "--cache-dir" || arg == "--cache-max-mb";
+    };
+    const std::vector<std::string> args(argv, argv + argc);
+
+    // result cache: the job must parse as a plain transform chain (no --write side outputs)
+    std::unique_ptr<ResultCache> result_cache;
+    std::string cache_key;
+    if (!cache_dir.empty() && !stream_in && !stream_out) {
+        std::vector<std::string> job_args;
+        for (size_t i = 3; i < args.size(); ++i) {
+            if (is_run_option(args[i])) {
+                ++i;
+                continue;
+            }
+            job_args.push_back(args[i]);
+        }
+        JobOptions job;
+        std::string error;
+        result_cache = std::make_unique<ResultCache>(cache_dir, cache_max_mb << 20);
+        if (!ParseJobOptions(job_args, job, error) ||
+            !result_cache->make_key(input_path, input_format, output_format, job, cache_key)) {
+            os << "[Cache] not cacheable, running without the cache\n";
+            log_file << "[Cache] not cacheable" << (error.empty() ? "" : ": " + error) << "\n";
+            result_cache.reset();
+        }
+    }
+    if (result_cache) {
+        const bool hit = result_cache->fetch(cache_key, output_path);
+        uint64_t hits = 0, misses = 0;
+        result_cache->count(hit, hits, misses);
+        os << "[Cache] " << (hit ? "hit " : "miss ") << cache_key << " (" << hits << " hits, "
+            << misses << " misses in " << cache_dir << ")\n";
+        log_file << "[Cache] " << (hit ? "hit " : "miss ") << cache_key << " (" << hits << " hits, "
+            << misses << " misses in " << cache_dir << ")\n";
+        if (hit) {
+            os << "\n✅ Transformation complete (cached).\n"
+                << "Input:  " << input_path << "\n"
+                << "Output: " << output_path << "\n"
+                << "Log:    " << (log_path.empty() ? "(none)" : log_path) << "\n";
+            log_file << "\n✅ Transformation complete (cached).\n";
+            return 0;
+        }
+    }
+
+    std::shared_ptr<file::CMeshFile> mesh_file = file::CreateMeshFile(input_format);
+    if (!(stream_in ? mesh_file->read(std::cin) : mesh_file->read(input_path))) {
         std::cerr << "❌ Error: failed to load input file: " << input_path << "\n";
         log_file << "❌ Failed to load input mesh\n";
         return 1;
     }
 
-    os << "✅ Loaded mesh with " << obj_file->mesh()->vertices().size()
+    os << "✅ Loaded mesh with " << mesh_file->mesh()->vertices().size()
         << " vertices from " << input_path << "\n";
-    log_file << "Loaded mesh with " << obj_file->mesh()->vertices().size() << " vertices\n";
+    log_file << "Loaded mesh with " << mesh_file->mesh()->vertices().size() << " vertices\n";
+    if (auto quantized = std::dynamic_pointer_cast<file::CQuantizedFile>(mesh_file)) {
+        PrintCodecStats(os, "decode", quantized->last_stats());
+        PrintCodecStats(log_file, "decode", quantized->last_stats());
+    }
 
     linear_algebra::Matrix4x4 transform;
+    std::string group_scope;  // empty: transforms apply to the whole mesh
+    int quant_bits = 16;
     os << "\n=== Begin Transformation Sequence ===\n";
     log_file << "\n=== Begin Transformation Sequence ===\n";
 
+    // apply the matrix accumulated for the current scope, then start a fresh one
+    auto apply_scope = [&]() {
+        auto mesh = mesh_file->mesh();
+        if (group_scope.empty()) {
+            if (transform.data() == linear_algebra::Matrix4x4::Identity().data()) return;
+            os << "\n=== Mesh Transform Matrix ===\n";
+            log_file << "\n=== Mesh Transform Matrix ===\n";
+            if (verbose) PrintMatrix(os, transform);
+            PrintMatrix(log_file, transform);
+            mesh->apply_transform(transform);
+        }
+        else {
+            // a stage since --group (e.g. --weld) may have removed all of the group's faces
+            const VertexSelection* found = mesh->select_group(group_scope);
+            if (!found) {
+                throw std::runtime_error("group '" + group_scope + "' has no faces left");
+            }
+            const VertexSelection& selection = *found;
+            os << "\n=== Group '" << group_scope << "' Transform Matrix ("
+                << selection.vertices_.size() << " vertices) ===\n";
+            log_file << "\n=== Group '" << group_scope << "' Transform Matrix ("
+                << selection.vertices_.size() << " vertices) ===\n";
+            if (verbose) PrintMatrix(os, transform);
+            PrintMatrix(log_file, transform);
+            mesh->apply_transform(transform, selection);
+        }
+        transform = linear_algebra::Matrix4x4();
+    };
+
+    // the mesh as it is now; "-" is stdout in output_format. nullptr on failure
+    auto write_mesh = [&](const std::string& path) -> std::shared_ptr<file::CMeshFile> {
+        const file::MeshFormat format = path == "-" ? output_format : file::FormatFromPath(path);
+        std::shared_ptr<file::CMeshFile> writer = file::CreateWriter(mesh_file, format);
+        if (!writer) return nullptr;
+        if (auto quantized = std::dynamic_pointer_cast<file::CQuantizedFile>(writer)) {
+            quantized->set_position_bits(quant_bits);
+        }
+        const bool written = path == "-" ? writer->write(std::cout) && std::cout.flush() : writer->write(path);
+        return written ? writer : nullptr;
+    };
+
     for (int i = 3; i < argc; ++i) {
         std::string arg = argv[i];
 
         // 跳过提前处理过的参数
-        if (arg == "--log" || arg == "--verbose") {
+        if (is_run_option(arg)) {
             ++i;
             continue;
         }
 
         try {
-            if (arg == "--translate" && i + 3 < argc) {
-                double tx = std::stod(argv[++i]);
-                double ty = std::stod(argv[++i]);
-                double tz = std::stod(argv[++i]);
-                os << "\n[Transform] Translate (" << tx << ", " << ty << ", " << tz << ")\n";
-                log_file << "\n[Transform] Translate (" << tx << ", " << ty << ", " << tz << ")\n";
-                transform = linear_algebra::Matrix4x4::Translate(tx, ty, tz) * transform;
-                if (verbose) {
-                    PrintMatrix(os, transform);
-                }  
-                PrintMatrix(log_file, transform);
-
-            }
-            else if (arg == "--scale" && i + 1 < argc) {
-                double s = std::stod(argv[++i]);
-                os << "\n[Transform] Scale (" << s << ")\n";
-                log_file << "\n[Transform] Scale (" << s << ")\n";
-                transform = linear_algebra::Matrix4x4::Scale(s) * transform;
+            linear_algebra::Matrix4x4 op;
+            std::string label;
+            JobStage stage;
+            size_t next = static_cast<size_t>(i);
+            if (ParseTransformOption(args, next, op, label)) {
+                i = static_cast<int>(next);
+                os << "\n[Transform] " << label << "\n";
+                log_file << "\n[Transform] " << label << "\n";
+                transform = op * transform;
                 if (verbose) {
                     PrintMatrix(os, transform);
                 }
                 PrintMatrix(log_file, transform);
 
             }
-            else if (arg == "--scale-nonuniform" && i + 3 < argc) {
-                double sx = std::stod(argv[++i]);
-                double sy = std::stod(argv[++i]);
-                double sz = std::stod(argv[++i]);
-                os << "\n[Transform] ScaleNonUniform (" << sx << ", " << sy << ", " << sz << ")\n";
-                log_file << "\n[Transform] ScaleNonUniform (" << sx << ", " << sy << ", " << sz << ")\n";
-                transform = linear_algebra::Matrix4x4::ScaleNonUniform(sx, sy, sz) * transform;
-                if (verbose) {
-                    PrintMatrix(os, transform);
+            else if (ParseStageOption(args, next, stage)) {
+                // mesh stages see every transform given before them
+                i = static_cast<int>(next);
+                apply_scope();
+                std::string report, error;
+                if (!ApplyJobStage(*mesh_file->mesh(), stage, report, error)) {
+                    throw std::runtime_error(error);
                 }
-                PrintMatrix(log_file, transform);
-
+                os << "\n" << report;
+                log_file << "\n" << report;
             }
-            else if (arg == "--rotate-x" && i + 1 < argc) {
-                double angle = DegToRad(std::stod(argv[++i]));
-                os << "\n[Transform] RotateX (" << angle << " rad)\n";
-                log_file << "\n[Transform] RotateX (" << angle << " rad)\n";
-                transform = linear_algebra::Matrix4x4::RotateX(angle) * transform;
-                if (verbose) {
-                    PrintMatrix(os, transform);
+            else if (arg == "--write" && i + 1 < argc) {
+                const std::string path = argv[++i];
+                if (path == "-" && stream_out) {
+                    throw std::invalid_argument("stdout already carries the final output");
                 }
-                PrintMatrix(log_file, transform);
-
-            }
-            else if (arg == "--rotate-y" && i + 1 < argc) {
-                double angle = DegToRad(std::stod(argv[++i]));
-                os << "\n[Transform] RotateY (" << angle << " rad)\n";
-                log_file << "\n[Transform] RotateY (" << angle << " rad)\n";
-                transform = linear_algebra::Matrix4x4::RotateY(angle) * transform;
-                if (verbose) {
-                    PrintMatrix(os, transform);
+                apply_scope();
+                if (!write_mesh(path)) {
+                    throw std::runtime_error("failed to write " + path);
                 }
-                PrintMatrix(log_file, transform);
-
+                os << "\n[Write] " << path << "\n";
+                log_file << "\n[Write] " << path << "\n";
             }
-            else if (arg == "--rotate-z" && i + 1 < argc) {
-                double angle = DegToRad(std::stod(argv[++i]));
-                os << "\n[Transform] RotateZ (" << angle << " rad)\n";
-                log_file << "\n[Transform] RotateZ (" << angle << " rad)\n";
-                transform = linear_algebra::Matrix4x4::RotateZ(angle) * transform;
-                if (verbose) {
-                    PrintMatrix(os, transform);
+            else if (arg == "--group" && i + 1 < argc) {
+                const std::string name = argv[++i];
+                if (!mesh_file->mesh()->select_group(name)) {
+                    throw std::invalid_argument("no o/g group named '" + name + "'");
                 }
-                PrintMatrix(log_file, transform);
-
+                apply_scope();
+                group_scope = name;
+                os << "\n[Scope] group '" << name << "'\n";
+                log_file << "\n[Scope] group '" << name << "'\n";
             }
-            else if (arg == "--rotate-axis" && i + 4 < argc) {
-                double ax = std::stod(argv[++i]);
-                double ay = std::stod(argv[++i]);
-                double az = std::stod(argv[++i]);
-                double angle = DegToRad(std::stod(argv[++i]));
-                os << "\n[Transform] RotateAxis axis=(" << ax << ", " << ay << ", " << az
-                    << "), angle=" << angle << " rad\n";
-                log_file << "\n[Transform] RotateAxis axis=(" << ax << ", " << ay << ", " << az
-                    << "), angle=" << angle << " rad\n";
-                transform = linear_algebra::Matrix4x4::RotateAroundAxis(linear_algebra::Vector3(ax, ay, az), angle) * transform;
-                if (verbose) {
-                    PrintMatrix(os, transform);
-                }
-                PrintMatrix(log_file, transform);
-
+            else if (arg == "--all") {
+                apply_scope();
+                group_scope.clear();
+                os << "\n[Scope] whole mesh\n";
+                log_file << "\n[Scope] whole mesh\n";
             }
-            else if (arg == "--shear" && i + 6 < argc) {
-                double sxy = std::stod(argv[++i]);
-                double sxz = std::stod(argv[++i]);
-                double syx = std::stod(argv[++i]);
-                double syz = std::stod(argv[++i]);
-                double szx = std::stod(argv[++i]);
-                double szy = std::stod(argv[++i]);
-                os << "\n[Transform] Shear ("
-                    << sxy << ", " << sxz << ", " << syx << ", "
-                    << syz << ", " << szx << ", " << szy << ")\n";
-                log_file << "\n[Transform] Shear ("
-                    << sxy << ", " << sxz << ", " << syx << ", "
-                    << syz << ", " << szx << ", " << szy << ")\n";
-                transform = linear_algebra::Matrix4x4::Shear(sxy, sxz, syx, syz, szx, szy) * transform;
-                if (verbose) {
-                    PrintMatrix(os, transform);
+            else if (arg == "--quant-bits" && i + 1 < argc) {
+                quant_bits = std::stoi(argv[++i]);
+                if (quant_bits < 1 || quant_bits > 30) {
+                    throw std::out_of_range("bit depth must be in [1, 30]");
                 }
-                PrintMatrix(log_file, transform);
-
             }
             else {
                 std::cerr << "\n⚠️ Unknown or malformed option: " << arg << "\n";
@@ -269,23 +522,48 @@ int main(int argc, char** argv) {
         }
     }
 
-    os << "\n=== Final Transform Matrix ===\n";
-    log_file << "\n=== Final Transform Matrix ===\n";
-    if (verbose) PrintMatrix(os, transform);
-    PrintMatrix(log_file, transform);
+    if (group_scope.empty()) {
+        os << "\n=== Final Transform Matrix ===\n";
+        log_file << "\n=== Final Transform Matrix ===\n";
+        if (verbose) PrintMatrix(os, transform);
+        PrintMatrix(log_file, transform);
 
-    obj_file->mesh()->apply_transform(transform);
+        mesh_file->mesh()->apply_transform(transform);
+    }
+    else {
+        try {
+            apply_scope();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "❌ Error: " << e.what() << "\n";
+            log_file << "❌ " << e.what() << "\n";
+            return 1;
+        }
+    }
 
-    if (!obj_file->write(output_path)) {
+    std::shared_ptr<file::CMeshFile> output_file = write_mesh(output_path);
+    if (!output_file) {
         std::cerr << "❌ Error: failed to save output file: " << output_path << "\n";
         log_file << "❌ Failed to save output mesh\n";
         return 1;
     }
 
-    std::cout << "\n✅ Transformation complete.\n"
+    if (auto quantized_output = std::dynamic_pointer_cast<file::CQuantizedFile>(output_file)) {
+        os << "\n=== Quantized Encoding (" << quant_bits << " bit positions) ===\n";
+        log_file << "\n=== Quantized Encoding (" << quant_bits << " bit positions) ===\n";
+        PrintCodecStats(os, "encode", quantized_output->last_stats());
+        PrintCodecStats(log_file, "encode", quantized_output->last_stats());
+    }
+
+    if (result_cache && !result_cache->store(cache_key, output_path)) {
+        os << "⚠️ [Cache] failed to store the result in " << cache_dir << "\n";
+        log_file << "⚠️ [Cache] failed to store " << cache_key << "\n";
+    }
+
+    os << "\n✅ Transformation complete.\n"
         << "Input:  " << input_path << "\n"
         << "Output: " << output_path << "\n"
-        << "Log:    " << log_path << "\n";
+        << "Log:    " << (log_path.empty() ? "(none)" : log_path) << "\n";
     log_file << "\n✅ Transformation complete.\n";
 
     return 0;
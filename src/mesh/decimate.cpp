@@ -0,0 +1,738 @@
+#include "mesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace mesh {
+    using linear_algebra::Vector2;
+    using linear_algebra::Vector3;
+
+    namespace {
+        constexpr uint32_t kInvalid = 0xffffffffu;
+        constexpr double kBorderWeight = 10.0;
+        // corner normals closer than this (cos 30 deg) are one smooth normal, so per-facet
+        // normals of a welded STL do not lock every vertex
+        constexpr double kSeamCosine = 0.866;
+        // peak working set of one Decimator run and its local vertex copy, measured at about
+        // 180 bytes per triangle on a 2M triangle grid, rounded up
+        constexpr size_t kWorkingBytesPerTriangle = 256;
+        // bounded decimation passes, each with its runs cut elsewhere (box grown by kRunShift)
+        constexpr int kMaxRunPasses = 3;
+        constexpr double kRunShift = 0.3;
+
+        // 30 bit Morton code of p inside the box lo + extent, 10 bits per axis
+        uint32_t MortonCode(const Vector3& p, const Vector3& lo, const Vector3& extent) {
+            auto spread = [](double t, double size) {
+                uint32_t x = size > 0 ? static_cast<uint32_t>(std::min(std::max(t / size, 0.0), 1.0) * 1023.0) : 0;
+                x = (x | (x << 16)) & 0x030000ffu;
+                x = (x | (x << 8)) & 0x0300f00fu;
+                x = (x | (x << 4)) & 0x030c30c3u;
+                x = (x | (x << 2)) & 0x09249249u;
+                return x;
+            };
+            return spread(p.x_ - lo.x_, extent.x_) | (spread(p.y_ - lo.y_, extent.y_) << 1) |
+                (spread(p.z_ - lo.z_, extent.z_) << 2);
+        }
+
+        // faces the decimator triangulates; everything else passes through unchanged
+        bool IsDecimatable(const Face& face, size_t vertex_count) {
+            if (face.vIdx_.size() < 3) return false;
+            for (int v : face.vIdx_) {
+                if (!IsValidIndex(v, vertex_count)) return false;
+            }
+            return true;
+        }
+
+        enum VertexKind : uint8_t {
+            kManifold = 0,  // free to collapse into any neighbour
+            kBorder = 1,    // may only slide along a border edge into another border vertex
+            kLocked = 2,    // uv/normal seam (differing values) or non-manifold: never removed
+        };
+
+        // symmetric 4x4 plane quadric (Garland & Heckbert 1997)
+        struct Quadric {
+            double a2 = 0, ab = 0, ac = 0, ad = 0;
+            double b2 = 0, bc = 0, bd = 0;
+            double c2 = 0, cd = 0;
+            double d2 = 0;
+
+            static Quadric FromPlane(const Vector3& n, double d, double weight) {
+                Quadric q;
+                q.a2 = weight * n.x_ * n.x_; q.ab = weight * n.x_ * n.y_; q.ac = weight * n.x_ * n.z_; q.ad = weight * n.x_ * d;
+                q.b2 = weight * n.y_ * n.y_; q.bc = weight * n.y_ * n.z_; q.bd = weight * n.y_ * d;
+                q.c2 = weight * n.z_ * n.z_; q.cd = weight * n.z_ * d;
+                q.d2 = weight * d * d;
+                return q;
+            }
+
+            Quadric& operator+=(const Quadric& rhs) {
+                a2 += rhs.a2; ab += rhs.ab; ac += rhs.ac; ad += rhs.ad;
+                b2 += rhs.b2; bc += rhs.bc; bd += rhs.bd;
+                c2 += rhs.c2; cd += rhs.cd;
+                d2 += rhs.d2;
+                return *this;
+            }
+
+            double error(const Vector3& p) const {
+                const double x = p.x_, y = p.y_, z = p.z_;
+                const double e = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+                    + b2 * y * y + 2 * bc * y * z + 2 * bd * y
+                    + c2 * z * z + 2 * cd * z
+                    + d2;
+                return e < 0 ? 0 : e;
+            }
+        };
+
+        // Indexed 4-ary min-heap holding one entry per vertex: its cheapest outgoing
+        // collapse. Costs are updated in place, so there are no stale entries and memory
+        // stays at three words per vertex regardless of how many collapses run. Entries
+        // carry their cost and the four siblings are contiguous, so a sift reads about
+        // one cache line per level of a tree half as deep as a binary heap.
+        class CollapseQueue {
+        public:
+            explicit CollapseQueue(size_t vertex_count)
+                : cost_(vertex_count, std::numeric_limits<float>::infinity()),
+                  position_(vertex_count, kInvalid) {
+                heap_.reserve(vertex_count);
+            }
+
+            bool empty() const { return heap_.empty(); }
+            uint32_t top() const { return heap_[0].vertex_; }
+            float cost(uint32_t v) const { return cost_[v]; }
+
+            // insert, reprioritize or (for an infinite cost) remove v
+            void update(uint32_t v, float cost) {
+                const float old_cost = cost_[v];
+                cost_[v] = cost;
+                if (position_[v] == kInvalid) {
+                    if (cost == std::numeric_limits<float>::infinity()) return;
+                    position_[v] = static_cast<uint32_t>(heap_.size());
+                    heap_.push_back({ cost, v });
+                    sift_up(position_[v]);
+                    return;
+                }
+                if (cost == std::numeric_limits<float>::infinity()) {
+                    remove(v);
+                    return;
+                }
+                heap_[position_[v]].cost_ = cost;
+                if (cost < old_cost) sift_up(position_[v]);
+                else sift_down(position_[v]);
+            }
+
+            void remove(uint32_t v) {
+                const uint32_t pos = position_[v];
+                if (pos == kInvalid) return;
+                const Entry last = heap_.back();
+                heap_.pop_back();
+                position_[v] = kInvalid;
+                if (last.vertex_ == v) return;
+                place(pos, last);
+                if (pos > 0 && last.cost_ < heap_[(pos - 1) / kArity].cost_) sift_up(pos);
+                else sift_down(pos);
+            }
+
+        private:
+            static constexpr uint32_t kArity = 4;
+
+            struct Entry {
+                float cost_;
+                uint32_t vertex_;
+            };
+
+            void sift_up(uint32_t pos) {
+                const Entry entry = heap_[pos];
+                while (pos > 0) {
+                    const uint32_t parent = (pos - 1) / kArity;
+                    if (heap_[parent].cost_ <= entry.cost_) break;
+                    place(pos, heap_[parent]);
+                    pos = parent;
+                }
+                place(pos, entry);
+            }
+
+            void sift_down(uint32_t pos) {
+                const Entry entry = heap_[pos];
+                const uint32_t size = static_cast<uint32_t>(heap_.size());
+                for (;;) {
+                    const uint32_t first = pos * kArity + 1;
+                    if (first >= size) break;
+                    const uint32_t last = std::min(first + kArity, size);
+                    uint32_t child = first;
+                    for (uint32_t c = first + 1; c < last; ++c) {
+                        if (heap_[c].cost_ < heap_[child].cost_) child = c;
+                    }
+                    if (entry.cost_ <= heap_[child].cost_) break;
+                    place(pos, heap_[child]);
+                    pos = child;
+                }
+                place(pos, entry);
+            }
+
+            void place(uint32_t pos, const Entry& entry) {
+                heap_[pos] = entry;
+                position_[entry.vertex_] = pos;
+            }
+
+            std::vector<float> cost_;
+            std::vector<uint32_t> position_;
+            std::vector<Entry> heap_;
+        };
+
+        // Triangle soup with per-vertex corner lists. Corner c belongs to triangle c / 3;
+        // next_corner_ chains all corners referencing the same vertex, so a collapse only
+        // relinks the removed vertex's list instead of reallocating adjacency.
+        class Decimator {
+        public:
+            Decimator(const std::vector<Vector3>& vertices, const std::vector<Vector2>& texcoords,
+                const std::vector<Vector3>& normals, const std::vector<Face>& faces)
+                : vertices_(vertices), texcoords_(texcoords), normals_(normals), queue_(vertices.size()) {
+                triangulate(faces);
+                build_corner_lists();
+                const std::vector<uint8_t> edge_triangles = count_edge_triangles();
+                classify_vertices(edge_triangles);
+                build_quadrics(edge_triangles);
+            }
+
+            size_t triangle_count() const { return live_triangles_; }
+
+            // never remove v (a vertex shared with faces outside this run); before run()
+            void lock(uint32_t v) { kind_[v] = kLocked; }
+
+            void run(size_t target_triangles) {
+                for (uint32_t v = 0; v < vertices_.size(); ++v) {
+                    update_vertex(v);
+                }
+                while (live_triangles_ > target_triangles && !queue_.empty()) {
+                    const uint32_t from = queue_.top();
+                    const uint32_t to = target_[from];
+                    if (!can_collapse(from, to)) {
+                        // retried once a neighbouring collapse changes the one-ring
+                        queue_.remove(from);
+                        continue;
+                    }
+                    collapse(from, to);
+                }
+            }
+
+            // emit surviving triangles in source face order; faces with fewer than three
+            // corners or invalid indices pass through unchanged. new_first[f] receives the
+            // output position of source face f
+            std::vector<Face> extract(const std::vector<Face>& faces, std::vector<uint32_t>& new_first) const {
+                std::vector<Face> out;
+                out.reserve(live_triangles_);
+                new_first.resize(faces.size() + 1);
+                size_t t = 0;
+                for (size_t f = 0; f < faces.size(); ++f) {
+                    new_first[f] = static_cast<uint32_t>(out.size());
+                    if (face_triangles_[f] == 0) {
+                        out.push_back(faces[f]);
+                        continue;
+                    }
+                    for (const size_t end = t + face_triangles_[f]; t < end; ++t) {
+                        if (dead_[t]) continue;
+                        Face face;
+                        for (int k = 0; k < 3; ++k) {
+                            const size_t c = t * 3 + k;
+                            face.vIdx_.push_back(static_cast<int>(corner_v_[c]));
+                            face.vtIdx_.push_back(corner_vt_[c]);
+                            face.vnIdx_.push_back(corner_vn_[c]);
+                        }
+                        out.push_back(std::move(face));
+                    }
+                }
+                new_first[faces.size()] = static_cast<uint32_t>(out.size());
+                return out;
+            }
+
+        private:
+            void triangulate(const std::vector<Face>& faces) {
+                face_triangles_.assign(faces.size(), 0);
+                size_t triangles = 0;
+                for (size_t f = 0; f < faces.size(); ++f) {
+                    const auto& face = faces[f];
+                    if (!IsDecimatable(face, vertices_.size())) continue;
+                    face_triangles_[f] = static_cast<uint32_t>(face.vIdx_.size() - 2);
+                    for (size_t i = 1; i + 1 < face.vIdx_.size(); ++i) {
+                        for (size_t k : { size_t(0), i, i + 1 }) {
+                            corner_v_.push_back(static_cast<uint32_t>(face.vIdx_[k]));
+                            corner_vt_.push_back(k < face.vtIdx_.size() ? face.vtIdx_[k] : -1);
+                            corner_vn_.push_back(k < face.vnIdx_.size() ? face.vnIdx_[k] : -1);
+                        }
+                        ++triangles;
+                    }
+                }
+                live_triangles_ = triangles;
+                dead_.assign(triangles, 0);
+            }
+
+            void build_corner_lists() {
+                head_.assign(vertices_.size(), kInvalid);
+                tail_.assign(vertices_.size(), kInvalid);
+                next_corner_.assign(corner_v_.size(), kInvalid);
+                for (size_t c = corner_v_.size(); c-- > 0;) {
+                    const uint32_t v = corner_v_[c];
+                    if (head_[v] == kInvalid) tail_[v] = static_cast<uint32_t>(c);
+                    next_corner_[c] = head_[v];
+                    head_[v] = static_cast<uint32_t>(c);
+                }
+                target_.assign(vertices_.size(), kInvalid);
+                removed_.assign(vertices_.size(), 0);
+            }
+
+            template <typename Fn>
+            void for_each_corner(uint32_t v, Fn&& fn) const {
+                for (uint32_t c = head_[v]; c != kInvalid; c = next_corner_[c]) {
+                    if (!dead_[c / 3]) fn(c);
+                }
+            }
+
+            // live triangles that contain the directed edge a->b or b->a
+            int edge_triangle_count(uint32_t a, uint32_t b) const {
+                int count = 0;
+                for_each_corner(a, [&](uint32_t c) {
+                    const uint32_t base = c - c % 3;
+                    for (int k = 0; k < 3; ++k) {
+                        if (corner_v_[base + k] == b) { ++count; break; }
+                    }
+                });
+                return count;
+            }
+
+            // for every corner c, the number of triangles sharing the edge from c's vertex to the
+            // next corner's (clamped to 3); one sorted neighbour list per vertex instead of
+            // a one-ring walk per edge
+            std::vector<uint8_t> count_edge_triangles() const {
+                std::vector<uint8_t> counts(corner_v_.size(), 0);
+                std::vector<uint32_t> ring;
+                for (uint32_t v = 0; v < vertices_.size(); ++v) {
+                    ring.clear();
+                    for_each_corner(v, [&](uint32_t c) {
+                        const uint32_t base = c - c % 3;
+                        ring.push_back(corner_v_[base + (c % 3 + 1) % 3]);
+                        ring.push_back(corner_v_[base + (c % 3 + 2) % 3]);
+                    });
+                    std::sort(ring.begin(), ring.end());
+                    for_each_corner(v, [&](uint32_t c) {
+                        const uint32_t next = corner_v_[c - c % 3 + (c % 3 + 1) % 3];
+                        const auto range = std::equal_range(ring.begin(), ring.end(), next);
+                        counts[c] = static_cast<uint8_t>(std::min<ptrdiff_t>(range.second - range.first, 3));
+                    });
+                }
+                return counts;
+            }
+
+            // different indices may still name the same uv or (nearly) the same normal
+            bool same_texcoord(int a, int b) const {
+                if (a == b) return true;
+                if (!IsValidIndex(a, texcoords_.size()) || !IsValidIndex(b, texcoords_.size())) return false;
+                return texcoords_[a].x_ == texcoords_[b].x_ && texcoords_[a].y_ == texcoords_[b].y_;
+            }
+
+            bool same_normal(int a, int b) const {
+                if (a == b) return true;
+                if (!IsValidIndex(a, normals_.size()) || !IsValidIndex(b, normals_.size())) return false;
+                const Vector3& na = normals_[a];
+                const Vector3& nb = normals_[b];
+                return na.dot(nb) > kSeamCosine * std::sqrt(na.dot(na) * nb.dot(nb));
+            }
+
+            void classify_vertices(const std::vector<uint8_t>& edge_triangles) {
+                kind_.assign(vertices_.size(), kManifold);
+                for (uint32_t v = 0; v < vertices_.size(); ++v) {
+                    if (head_[v] == kInvalid) continue;
+                    const int vt = corner_vt_[head_[v]];
+                    const int vn = corner_vn_[head_[v]];
+                    bool seam = false, border = false, non_manifold = false;
+                    for_each_corner(v, [&](uint32_t c) {
+                        seam = seam || !same_texcoord(corner_vt_[c], vt) || !same_normal(corner_vn_[c], vn);
+                        const int shared = edge_triangles[c];
+                        border = border || shared == 1;
+                        non_manifold = non_manifold || shared > 2;
+                    });
+                    if (seam || non_manifold) kind_[v] = kLocked;
+                    else if (border) kind_[v] = kBorder;
+                }
+            }
+
+            void build_quadrics(const std::vector<uint8_t>& edge_triangles) {
+                quadrics_.assign(vertices_.size(), Quadric());
+                for (size_t t = 0; t < dead_.size(); ++t) {
+                    const uint32_t i0 = corner_v_[t * 3], i1 = corner_v_[t * 3 + 1], i2 = corner_v_[t * 3 + 2];
+                    const Vector3& p0 = vertices_[i0];
+                    const Vector3& p1 = vertices_[i1];
+                    const Vector3& p2 = vertices_[i2];
+                    const Vector3 cross = (p1 - p0).cross(p2 - p0);
+                    const double area = 0.5 * std::sqrt(cross.dot(cross));
+                    const Vector3 n = cross.normalized();
+                    const Quadric q = Quadric::FromPlane(n, -n.dot(p0), area);
+                    quadrics_[i0] += q;
+                    quadrics_[i1] += q;
+                    quadrics_[i2] += q;
+
+                    // border edges get a perpendicular constraint plane so outlines keep their shape
+                    const uint32_t idx[3] = { i0, i1, i2 };
+                    for (int k = 0; k < 3; ++k) {
+                        const uint32_t a = idx[k], b = idx[(k + 1) % 3];
+                        if (edge_triangles[t * 3 + k] != 1) continue;
+                        const Vector3 edge = vertices_[b] - vertices_[a];
+                        const Vector3 side = edge.cross(n).normalized();
+                        const double length2 = edge.dot(edge);
+                        const Quadric bq = Quadric::FromPlane(side, -side.dot(vertices_[a]), kBorderWeight * length2);
+                        quadrics_[a] += bq;
+                        quadrics_[b] += bq;
+                    }
+                }
+            }
+
+            double collapse_cost(uint32_t from, uint32_t to) const {
+                Quadric q = quadrics_[from];
+                q += quadrics_[to];
+                return q.error(vertices_[to]);
+            }
+
+            bool allowed_direction(uint32_t from, uint32_t to) const {
+                switch (kind_[from]) {
+                case kManifold: return true;
+                case kBorder: return kind_[to] != kManifold && edge_triangle_count(from, to) == 1;
+                default: return false;
+                }
+            }
+
+            // recompute the cheapest allowed collapse leaving v
+            void update_vertex(uint32_t v) {
+                float best_cost = std::numeric_limits<float>::infinity();
+                uint32_t best = kInvalid;
+                if (!removed_[v] && kind_[v] != kLocked) {
+                    for_each_corner(v, [&](uint32_t c) {
+                        const uint32_t base = c - c % 3;
+                        const uint32_t k = c % 3;
+                        for (uint32_t n : { corner_v_[base + (k + 1) % 3], corner_v_[base + (k + 2) % 3] }) {
+                            if (n == best || !allowed_direction(v, n)) continue;
+                            const float cost = static_cast<float>(collapse_cost(v, n));
+                            if (cost < best_cost) {
+                                best_cost = cost;
+                                best = n;
+                            }
+                        }
+                    });
+                }
+                target_[v] = best;
+                queue_.update(v, best_cost);
+            }
+
+            void collect_neighbours(uint32_t v, std::vector<uint32_t>& out) const {
+                out.clear();
+                for_each_corner(v, [&](uint32_t c) {
+                    const uint32_t base = c - c % 3;
+                    for (int k = 0; k < 3; ++k) {
+                        const uint32_t n = corner_v_[base + k];
+                        if (n != v) out.push_back(n);
+                    }
+                });
+                std::sort(out.begin(), out.end());
+                out.erase(std::unique(out.begin(), out.end()), out.end());
+            }
+
+            bool can_collapse(uint32_t from, uint32_t to) {
+                if (removed_[from] || removed_[to]) return false;
+
+                // some triangle at either end must survive, or the collapse deletes an isolated
+                // triangle (every triangle of an unwelded soup) or a whole small component
+                bool survivor = false;
+                for (uint32_t v : { from, to }) {
+                    const uint32_t other = v == from ? to : from;
+                    for_each_corner(v, [&](uint32_t c) {
+                        const uint32_t base = c - c % 3;
+                        survivor = survivor || (corner_v_[base] != other && corner_v_[base + 1] != other &&
+                            corner_v_[base + 2] != other);
+                    });
+                }
+                if (!survivor) return false;
+
+                // link condition: the one-rings may only share the edge's opposite vertices
+                collect_neighbours(from, ring_from_);
+                collect_neighbours(to, ring_to_);
+                size_t shared = 0;
+                for (size_t i = 0, j = 0; i < ring_from_.size() && j < ring_to_.size();) {
+                    if (ring_from_[i] < ring_to_[j]) ++i;
+                    else if (ring_to_[j] < ring_from_[i]) ++j;
+                    else { ++shared; ++i; ++j; }
+                }
+                if (shared != static_cast<size_t>(edge_triangle_count(from, to))) return false;
+
+                // reject collapses that flip or degenerate a surviving triangle
+                const Vector3& target = vertices_[to];
+                bool ok = true;
+                for_each_corner(from, [&](uint32_t c) {
+                    if (!ok) return;
+                    const uint32_t base = c - c % 3;
+                    const uint32_t k = c % 3;
+                    const uint32_t b = corner_v_[base + (k + 1) % 3];
+                    const uint32_t d = corner_v_[base + (k + 2) % 3];
+                    if (b == to || d == to) return;
+                    const Vector3& pb = vertices_[b];
+                    const Vector3& pd = vertices_[d];
+                    const Vector3 before = (pb - vertices_[from]).cross(pd - vertices_[from]);
+                    if (before.dot(before) == 0) return;
+                    const Vector3 after = (pb - target).cross(pd - target);
+                    const double len = std::sqrt(before.dot(before) * after.dot(after));
+                    ok = after.dot(before) > 0.25 * len;
+                });
+                return ok;
+            }
+
+            void collapse(uint32_t from, uint32_t to) {
+                // attributes of 'to' inside from's chart, taken from a triangle on the collapsed edge
+                int to_vt = -1, to_vn = -1;
+                for_each_corner(from, [&](uint32_t c) {
+                    const uint32_t base = c - c % 3;
+                    for (int k = 0; k < 3; ++k) {
+                        if (corner_v_[base + k] == to) {
+                            to_vt = corner_vt_[base + k];
+                            to_vn = corner_vn_[base + k];
+                        }
+                    }
+                });
+
+                for (uint32_t c = head_[from]; c != kInvalid; c = next_corner_[c]) {
+                    const uint32_t t = c / 3;
+                    if (dead_[t]) continue;
+                    const uint32_t base = t * 3;
+                    if (corner_v_[base] == to || corner_v_[base + 1] == to || corner_v_[base + 2] == to) {
+                        dead_[t] = 1;
+                        --live_triangles_;
+                        continue;
+                    }
+                    corner_v_[c] = to;
+                    corner_vt_[c] = to_vt;
+                    corner_vn_[c] = to_vn;
+                }
+
+                // splice from's corner list onto to's, dropping corners of dead triangles
+                // so list walks stay proportional to the current valence
+                if (head_[from] != kInvalid) {
+                    if (head_[to] == kInvalid) head_[to] = head_[from];
+                    else next_corner_[tail_[to]] = head_[from];
+                    tail_[to] = tail_[from];
+                    head_[from] = tail_[from] = kInvalid;
+                }
+                uint32_t* link = &head_[to];
+                tail_[to] = kInvalid;
+                while (*link != kInvalid) {
+                    if (dead_[*link / 3]) {
+                        *link = next_corner_[*link];
+                    }
+                    else {
+                        tail_[to] = *link;
+                        link = &next_corner_[*link];
+                    }
+                }
+
+                quadrics_[to] += quadrics_[from];
+                removed_[from] = 1;
+                queue_.remove(from);
+
+                // only edges into 'to' changed cost for its neighbours; a full rescan is
+                // needed only when the neighbour's best target was one of the endpoints
+                update_vertex(to);
+                collect_neighbours(to, ring_to_);
+                for (uint32_t n : ring_to_) {
+                    if (target_[n] == from || target_[n] == to || target_[n] == kInvalid) {
+                        update_vertex(n);
+                    }
+                    else if (allowed_direction(n, to)) {
+                        const float cost = static_cast<float>(collapse_cost(n, to));
+                        if (cost < queue_.cost(n)) {
+                            target_[n] = to;
+                            queue_.update(n, cost);
+                        }
+                    }
+                }
+            }
+
+            const std::vector<Vector3>& vertices_;
+            const std::vector<Vector2>& texcoords_;
+            const std::vector<Vector3>& normals_;
+            std::vector<uint32_t> corner_v_;
+            std::vector<int> corner_vt_;
+            std::vector<int> corner_vn_;
+            std::vector<uint32_t> next_corner_;
+            std::vector<uint32_t> head_;
+            std::vector<uint32_t> tail_;
+            std::vector<uint32_t> face_triangles_;
+            std::vector<uint8_t> dead_;
+            std::vector<uint8_t> kind_;
+            std::vector<uint8_t> removed_;
+            std::vector<uint32_t> target_;
+            std::vector<Quadric> quadrics_;
+            CollapseQueue queue_;
+            std::vector<uint32_t> ring_from_;
+            std::vector<uint32_t> ring_to_;
+            size_t live_triangles_ = 0;
+        };
+        // One bounded pass of Mesh::decimate. Decimatable faces are sorted along a Morton curve
+        // of their first corner and cut into runs of at most run_limit triangles, each simplified
+        // on its own; shift grows the curve's box by that fraction, which moves the cuts. Every
+        // run aims at the share of the target the runs so far should have reached, so a run held
+        // back by its locked border hands the rest on. Vertices used by more than one run are
+        // locked, so no run moves a vertex another run still references. Source faces are
+        // released as their run is consumed and the output keeps source face order. Returns
+        // the resulting triangle count.
+        size_t DecimateInRuns(Mesh& mesh, size_t target_triangles, size_t run_limit, double shift) {
+            const size_t vertex_count = mesh.vertices_.size();
+            std::vector<uint32_t> order;
+            size_t total = 0;
+            {
+                Vector3 lo = mesh.vertices_.empty() ? Vector3() : mesh.vertices_[0];
+                Vector3 hi = lo;
+                for (const Vector3& p : mesh.vertices_) {
+                    lo = Vector3(std::min(lo.x_, p.x_), std::min(lo.y_, p.y_), std::min(lo.z_, p.z_));
+                    hi = Vector3(std::max(hi.x_, p.x_), std::max(hi.y_, p.y_), std::max(hi.z_, p.z_));
+                }
+                const Vector3 extent = (hi - lo) * (1.0 + shift);
+                lo = lo - (hi - lo) * shift;
+                std::vector<uint32_t> code(mesh.faces_.size(), 0);
+                for (size_t f = 0; f < mesh.faces_.size(); ++f) {
+                    if (!IsDecimatable(mesh.faces_[f], vertex_count)) continue;
+                    order.push_back(static_cast<uint32_t>(f));
+                    code[f] = MortonCode(mesh.vertices_[mesh.faces_[f].vIdx_[0]], lo, extent);
+                    total += mesh.faces_[f].vIdx_.size() - 2;
+                }
+                std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+                    return code[a] != code[b] ? code[a] < code[b] : a < b;
+                });
+            }
+
+            std::vector<size_t> run_begin{ 0 };
+            size_t run_triangles = 0;
+            for (size_t i = 0; i < order.size(); ++i) {
+                const size_t triangles = mesh.faces_[order[i]].vIdx_.size() - 2;
+                if (run_triangles > 0 && run_triangles + triangles > run_limit) {
+                    run_begin.push_back(i);
+                    run_triangles = 0;
+                }
+                run_triangles += triangles;
+            }
+            run_begin.push_back(order.size());
+
+            constexpr uint32_t kShared = kInvalid - 1;
+            std::vector<uint32_t> owner(vertex_count, kInvalid);  // run using the vertex, or kShared
+            for (size_t r = 0; r + 1 < run_begin.size(); ++r) {
+                for (size_t i = run_begin[r]; i < run_begin[r + 1]; ++i) {
+                    for (int v : mesh.faces_[order[i]].vIdx_) {
+                        if (owner[v] == kInvalid) owner[v] = static_cast<uint32_t>(r);
+                        else if (owner[v] != r) owner[v] = kShared;
+                    }
+                }
+            }
+
+            // decimated faces in run order; source face f became out[out_begin[f], out_end[f])
+            std::vector<Face> out;
+            std::vector<uint32_t> out_begin(mesh.faces_.size(), kInvalid);
+            std::vector<uint32_t> out_end(mesh.faces_.size(), kInvalid);
+            std::vector<uint32_t> local_of(vertex_count, kInvalid);
+            std::vector<uint32_t> global_of;
+            std::vector<Vector3> local_vertices;
+            std::vector<Face> local_faces;
+            size_t processed = 0, result = 0;
+            for (size_t r = 0; r + 1 < run_begin.size(); ++r) {
+                global_of.clear();
+                local_vertices.clear();
+                local_faces.clear();
+                for (size_t i = run_begin[r]; i < run_begin[r + 1]; ++i) {
+                    local_faces.push_back(std::move(mesh.faces_[order[i]]));
+                    mesh.faces_[order[i]] = Face();
+                    for (int& v : local_faces.back().vIdx_) {
+                        if (local_of[v] == kInvalid) {
+                            local_of[v] = static_cast<uint32_t>(global_of.size());
+                            global_of.push_back(static_cast<uint32_t>(v));
+                            local_vertices.push_back(mesh.vertices_[v]);
+                        }
+                        v = static_cast<int>(local_of[v]);
+                    }
+                    processed += local_faces.back().vIdx_.size() - 2;
+                }
+
+                Decimator decimator(local_vertices, mesh.texcoords_, mesh.normals_, local_faces);
+                for (uint32_t v = 0; v < global_of.size(); ++v) {
+                    if (owner[global_of[v]] == kShared) decimator.lock(v);
+                }
+                const size_t goal = static_cast<size_t>(static_cast<double>(processed) * target_triangles / total);
+                decimator.run(goal > result ? goal - result : 0);
+                result += decimator.triangle_count();
+                std::vector<uint32_t> local_first;
+                std::vector<Face> decimated = decimator.extract(local_faces, local_first);
+
+                for (size_t i = run_begin[r]; i < run_begin[r + 1]; ++i) {
+                    const size_t local = i - run_begin[r];
+                    out_begin[order[i]] = static_cast<uint32_t>(out.size());
+                    for (uint32_t k = local_first[local]; k < local_first[local + 1]; ++k) {
+                        for (int& v : decimated[k].vIdx_) v = static_cast<int>(global_of[v]);
+                        out.push_back(std::move(decimated[k]));
+                    }
+                    out_end[order[i]] = static_cast<uint32_t>(out.size());
+                }
+                for (uint32_t v : global_of) local_of[v] = kInvalid;
+            }
+
+            std::vector<Face> faces;
+            std::vector<uint32_t> new_first(mesh.faces_.size() + 1);
+            for (size_t f = 0; f < mesh.faces_.size(); ++f) {
+                new_first[f] = static_cast<uint32_t>(faces.size());
+                if (out_begin[f] == kInvalid) {
+                    faces.push_back(std::move(mesh.faces_[f]));  // passed through
+                    continue;
+                }
+                for (uint32_t k = out_begin[f]; k < out_end[f]; ++k) faces.push_back(std::move(out[k]));
+            }
+            new_first[mesh.faces_.size()] = static_cast<uint32_t>(faces.size());
+
+            mesh.faces_ = std::move(faces);
+            mesh.groups_.remap_faces(new_first);
+            return result;
+        }
+    }  // namespace
+
+    size_t Mesh::triangle_count() const {
+
+        size_t triangles = 0;
+        for (const auto& face : faces_) {
+            if (face.vIdx_.size() >= 3) triangles += face.vIdx_.size() - 2;
+        }
+        return triangles;
+    }
+
+    size_t Mesh::decimate(size_t target_triangles, size_t max_working_bytes) {
+        const size_t total = triangle_count();
+        const size_t run_limit = std::max<size_t>(max_working_bytes / kWorkingBytesPerTriangle, 1);
+        if (max_working_bytes == 0 || total <= run_limit) {
+            Decimator decimator(vertices_, texcoords_, normals_, faces_);
+            decimator.run(target_triangles);
+            std::vector<uint32_t> new_first;
+            faces_ = decimator.extract(faces_, new_first);
+            groups_.remap_faces(new_first);
+            invalidate_selections();
+            compact();
+            return decimator.triangle_count();
+        }
+
+        // Bounded working set: spatially sorted runs of faces are simplified one at a time.
+        // Vertices shared between runs are locked, so each later pass cuts the runs at other
+        // places to release them, until the target is met or a pass makes no progress
+        size_t result = total;
+        for (int pass = 0; pass < kMaxRunPasses && result > target_triangles; ++pass) {
+            const size_t before = result;
+            result = DecimateInRuns(*this, target_triangles, run_limit, pass * kRunShift);
+            if (result >= before) break;
+        }
+        invalidate_selections();
+        compact();
+        return result;
+    }
+}  // namespace mesh
@@ -0,0 +1,89 @@
+#include "groups.h"
+
+#include <algorithm>
+
+namespace mesh {
+    void GroupTable::clear() {
+        names_.clear();
+        ids_.clear();
+        directives_.clear();
+        ranges_.clear();
+        ranges_valid_ = false;
+    }
+
+    uint32_t GroupTable::intern(const std::string& name) {
+        auto it = ids_.find(name);
+        if (it != ids_.end()) return it->second;
+        const uint32_t id = static_cast<uint32_t>(names_.size());
+        names_.push_back(name);
+        ids_.emplace(name, id);
+        return id;
+    }
+
+    void GroupTable::add(DirectiveKind kind, const std::string& name, uint32_t face) {
+        directives_.push_back({ face, kind, intern(name) });
+        ranges_valid_ = false;
+    }
+
+    const std::vector<FaceRange>* GroupTable::ranges(const std::string& name, uint32_t face_count) const {
+        auto id = ids_.find(name);
+        if (id == ids_.end()) return nullptr;
+        if (!ranges_valid_ || ranges_face_count_ != face_count) build_ranges(face_count);
+        auto it = ranges_.find(id->second);
+        return it == ranges_.end() ? nullptr : &it->second;
+    }
+
+    void GroupTable::build_ranges(uint32_t face_count) const {
+        ranges_.clear();
+        // "o" and "g" scopes are independent: each lasts until the next directive of its kind
+        for (DirectiveKind kind : { DirectiveKind::kObject, DirectiveKind::kGroup }) {
+            const Directive* open = nullptr;
+            auto close = [&](uint32_t end) {
+                if (open && end > open->face_) {
+                    ranges_[open->name_].push_back({ open->face_, end - open->face_ });
+                }
+            };
+            for (const auto& directive : directives_) {
+                if (directive.kind_ != kind) continue;
+                close(std::min(directive.face_, face_count));
+                open = &directive;
+            }
+            close(face_count);
+        }
+
+        // a name used for both "o" and "g", or reopened later, may overlap: merge
+        for (auto& entry : ranges_) {
+            auto& spans = entry.second;
+            std::sort(spans.begin(), spans.end(),
+                [](const FaceRange& a, const FaceRange& b) { return a.first_ < b.first_; });
+            size_t out = 0;
+            for (size_t i = 1; i < spans.size(); ++i) {
+                FaceRange& last = spans[out];
+                if (spans[i].first_ <= last.first_ + last.count_) {
+                    const uint32_t end = std::max(last.first_ + last.count_, spans[i].first_ + spans[i].count_);
+                    last.count_ = end - last.first_;
+                }
+                else {
+                    spans[++out] = spans[i];
+                }
+            }
+            spans.resize(spans.empty() ? 0 : out + 1);
+        }
+        ranges_face_count_ = face_count;
+        ranges_valid_ = true;
+    }
+
+    void GroupTable::append(const GroupTable& other, uint32_t face_offset) {
+        for (const auto& directive : other.directives_) {
+            add(directive.kind_, other.names_[directive.name_], directive.face_ + face_offset);
+        }
+    }
+
+    void GroupTable::remap_faces(const std::vector<uint32_t>& new_first) {
+        for (auto& directive : directives_) {
+            const size_t face = std::min<size_t>(directive.face_, new_first.size() - 1);
+            directive.face_ = new_first[face];
+        }
+        ranges_valid_ = false;
+    }
+}  // namespace mesh
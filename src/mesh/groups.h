@@ -0,0 +1,70 @@
+#ifndef MESH_GROUPS_H_
+#define MESH_GROUPS_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mesh {
+	// OBJ state directives kept alongside the faces
+	enum class DirectiveKind : uint8_t {
+		kMtlLib,    // "mtllib", file scope
+		kObject,    // "o"
+		kGroup,     // "g"
+		kMaterial,  // "usemtl"
+		kSmoothing, // "s"
+	};
+
+	// directive that takes effect before faces_[face_]; name_ indexes the interned name table
+	struct Directive {
+		uint32_t face_;
+		DirectiveKind kind_;
+		uint32_t name_;
+	};
+
+	// contiguous span of faces_
+	struct FaceRange {
+		uint32_t first_;
+		uint32_t count_;
+	};
+
+	// Directives in face order plus interned names. Object / group names resolve to
+	// their face ranges with a single hash lookup; ranges are built lazily once.
+	class GroupTable {
+	public:
+		explicit GroupTable() = default;
+
+		void clear();
+		bool empty() const { return directives_.empty(); }
+
+		uint32_t intern(const std::string& name);
+		const std::string& name(uint32_t id) const { return names_[id]; }
+
+		// directives must be added in non-decreasing face order
+		void add(DirectiveKind kind, const std::string& name, uint32_t face);
+		const std::vector<Directive>& directives() const { return directives_; }
+
+		// face ranges of an "o" or "g" name; nullptr when unknown
+		const std::vector<FaceRange>* ranges(const std::string& name, uint32_t face_count) const;
+
+		// append other's directives, shifted by face_offset
+		void append(const GroupTable& other, uint32_t face_offset);
+
+		// faces were rebuilt: old face f now starts at new_first[f] (size old count + 1)
+		void remap_faces(const std::vector<uint32_t>& new_first);
+
+	private:
+		void build_ranges(uint32_t face_count) const;
+
+		std::vector<std::string> names_;
+		std::unordered_map<std::string, uint32_t> ids_;
+		std::vector<Directive> directives_;
+
+		mutable std::unordered_map<uint32_t, std::vector<FaceRange>> ranges_;
+		mutable uint32_t ranges_face_count_ = 0;
+		mutable bool ranges_valid_ = false;
+	};
+}  // namespace mesh
+
+#endif  // MESH_GROUPS_H_
@@ -1,12 +1,39 @@
 #include "mesh.h"
 
+#include <algorithm>
 #include <fstream>
+#include <iterator>
 #include <sstream>
 
 namespace mesh {
     using linear_algebra::Matrix4x4;
     using linear_algebra::Vector3;
 
+    namespace {
+        bool RangesOverlap(std::vector<FaceRange> a, std::vector<FaceRange> b) {
+            auto by_first = [](const FaceRange& x, const FaceRange& y) { return x.first_ < y.first_; };
+            std::sort(a.begin(), a.end(), by_first);
+            std::sort(b.begin(), b.end(), by_first);
+            for (size_t i = 0, j = 0; i < a.size() && j < b.size();) {
+                const uint64_t a_end = uint64_t(a[i].first_) + a[i].count_;
+                const uint64_t b_end = uint64_t(b[j].first_) + b[j].count_;
+                if (a[i].first_ < b_end && b[j].first_ < a_end && a[i].count_ > 0 && b[j].count_ > 0) return true;
+                if (a_end < b_end) ++i;
+                else ++j;
+            }
+            return false;
+        }
+
+        bool SortedIntersect(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+            for (size_t i = 0, j = 0; i < a.size() && j < b.size();) {
+                if (a[i] == b[j]) return true;
+                if (a[i] < b[j]) ++i;
+                else ++j;
+            }
+            return false;
+        }
+    }  // namespace
+
     void Mesh::apply_transform(const Matrix4x4& matrix) {
         // transform all vertex
         for (auto& v : vertices_) {
@@ -14,15 +41,144 @@ namespace mesh {
             v = matrix * p;
         }
         // transform all normal
+        const Matrix4x4 normal_matrix = matrix.normal_matrix();
         for (auto& vu : normals_) {
             Vector3 p(vu.x_, vu.y_, vu.z_);
-            vu = matrix * p;
+            vu = normal_matrix * p;
             vu = vu.normalized();
         }
     }
 
+    void Mesh::apply_transform(const Matrix4x4& matrix, const VertexSelection& selection) {
+        for (uint32_t idx : selection.vertices_) {
+            Vector3& v = vertices_[idx];
+            v = matrix * v;
+        }
+
+        const Matrix4x4 normal_matrix = matrix.normal_matrix();
+        // copied: a cached selection is updated in place below
+        const std::vector<uint32_t> shared = selection.shared_normals_;
+        for (uint32_t idx : selection.normals_) {
+            if (std::binary_search(shared.begin(), shared.end(), idx)) continue;
+            Vector3& vn = normals_[idx];
+            vn = normal_matrix * vn;
+            vn = vn.normalized();
+        }
+        if (shared.empty()) return;
+
+        // shared normal k becomes normals_[first_copy + k] for the selected faces
+        const int first_copy = static_cast<int>(normals_.size());
+        for (uint32_t idx : shared) {
+            normals_.push_back((normal_matrix * normals_[idx]).normalized());
+        }
+        std::vector<uint32_t> copy_uses(shared.size(), 0);
+        for (const auto& range : selection.faces_) {
+            for (uint32_t f = range.first_; f < range.first_ + range.count_; ++f) {
+                for (int& vn_idx : faces_[f].vnIdx_) {
+                    if (vn_idx < 0 || vn_idx >= first_copy) continue;
+                    const auto it = std::lower_bound(shared.begin(), shared.end(), static_cast<uint32_t>(vn_idx));
+                    if (it != shared.end() && *it == static_cast<uint32_t>(vn_idx)) {
+                        const size_t k = it - shared.begin();
+                        vn_idx = first_copy + static_cast<int>(k);
+                        ++copy_uses[k];
+                    }
+                }
+            }
+        }
+
+        // the use counts move from the shared normals to their copies
+        if (normal_uses_.size() == static_cast<size_t>(first_copy)) {
+            for (size_t k = 0; k < shared.size(); ++k) normal_uses_[shared[k]] -= copy_uses[k];
+            normal_uses_.insert(normal_uses_.end(), copy_uses.begin(), copy_uses.end());
+        } else {
+            normal_uses_.clear();
+        }
+
+        // the selection now owns every normal it uses. other selections on the same faces,
+        // or sharing a detached normal, are rebuilt on next use
+        for (auto it = selections_.begin(); it != selections_.end();) {
+            VertexSelection& other = it->second;
+            if (&other == &selection) {
+                std::vector<uint32_t> normals;
+                normals.reserve(other.normals_.size());
+                std::set_difference(other.normals_.begin(), other.normals_.end(),
+                    shared.begin(), shared.end(), std::back_inserter(normals));
+                for (size_t k = 0; k < shared.size(); ++k) normals.push_back(static_cast<uint32_t>(first_copy + k));
+                other.normals_ = std::move(normals);
+                other.shared_normals_.clear();
+                ++it;
+            } else if (RangesOverlap(other.faces_, selection.faces_) || SortedIntersect(other.shared_normals_, shared)) {
+                it = selections_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    const VertexSelection* Mesh::select_group(const std::string& name) const {
+        auto cached = selections_.find(name);
+        if (cached != selections_.end()) return &cached->second;
+
+        const std::vector<FaceRange>* ranges = group_ranges(name);
+        if (!ranges) return nullptr;
+
+        // the vertex and normal lists follow the group's corner count
+        VertexSelection selection;
+        auto collect = [](const std::vector<int>& indices, size_t count, std::vector<uint32_t>& out) {
+            for (int idx : indices) {
+                if (idx >= 0 && static_cast<size_t>(idx) < count) out.push_back(static_cast<uint32_t>(idx));
+            }
+        };
+        for (const auto& range : *ranges) {
+            for (uint32_t f = range.first_; f < range.first_ + range.count_; ++f) {
+                collect(faces_[f].vIdx_, vertices_.size(), selection.vertices_);
+                collect(faces_[f].vnIdx_, normals_.size(), selection.normals_);
+            }
+        }
+        // a normal is shared when the mesh uses it more often than the group's own corners do
+        std::sort(selection.normals_.begin(), selection.normals_.end());
+        if (!selection.normals_.empty()) {
+            const std::vector<uint32_t>& uses = normal_uses();
+            for (size_t i = 0, j; i < selection.normals_.size(); i = j) {
+                for (j = i + 1; j < selection.normals_.size() && selection.normals_[j] == selection.normals_[i]; ++j) {}
+                if (uses[selection.normals_[i]] > j - i) selection.shared_normals_.push_back(selection.normals_[i]);
+            }
+        }
+        for (auto* list : { &selection.vertices_, &selection.normals_ }) {
+            std::sort(list->begin(), list->end());
+            list->erase(std::unique(list->begin(), list->end()), list->end());
+            list->shrink_to_fit();
+        }
+        selection.faces_ = *ranges;
+        return &selections_.emplace(name, std::move(selection)).first->second;
+    }
+
+    void Mesh::invalidate_selections() {
+        selections_.clear();
+        normal_uses_.clear();
+    }
+
+    const std::vector<uint32_t>& Mesh::normal_uses() const {
+        if (normal_uses_.size() != normals_.size()) {
+            normal_uses_.assign(normals_.size(), 0);
+            for (const auto& face : faces_) {
+                for (int idx : face.vnIdx_) {
+                    if (idx >= 0 && static_cast<size_t>(idx) < normal_uses_.size()) ++normal_uses_[idx];
+                }
+            }
+        }
+        return normal_uses_;
+    }
+
+    const std::vector<FaceRange>* Mesh::group_ranges(const std::string& name) const {
+        return groups_.ranges(name, static_cast<uint32_t>(faces_.size()));
+    }
+
     void Mesh::append(const Mesh& other) {
-        const unsigned int offset = vertices_.size();
+        const int offset = static_cast<int>(vertices_.size());
+        const int vt_offset = static_cast<int>(texcoords_.size());
+        const int vn_offset = static_cast<int>(normals_.size());
+        const uint32_t face_offset = static_cast<uint32_t>(faces_.size());
         for (const auto& vec : other.vertices_) {
             vertices_.push_back(vec);
         }
@@ -40,12 +196,63 @@ namespace mesh {
                 v_idx = v_idx < 0 ? v_idx : v_idx + offset;
             }
             for (auto& vt_idx : temp_face.vtIdx_) {
-                vt_idx = vt_idx < 0 ? vt_idx : vt_idx + offset;
+                vt_idx = vt_idx < 0 ? vt_idx : vt_idx + vt_offset;
             }
             for (auto& vn_idx : temp_face.vnIdx_) {
-                vn_idx = vn_idx < 0 ? vn_idx : vn_idx + offset;
+                vn_idx = vn_idx < 0 ? vn_idx : vn_idx + vn_offset;
             }
             faces_.push_back(temp_face);
         }
+
+        // close this mesh's trailing group so it does not swallow the appended faces
+        const bool other_opens_group = !other.groups_.empty() && other.groups_.directives().front().face_ == 0;
+        if (!groups_.empty() && !other_opens_group && other.faces_.size() > 0) {
+            groups_.add(DirectiveKind::kGroup, "default", face_offset);
+        }
+        groups_.append(other.groups_, face_offset);
+        invalidate_selections();
+    }
+
+    void Mesh::compact() {
+        invalidate_selections();
+        std::vector<int> v_remap(vertices_.size(), -1);
+        std::vector<int> vt_remap(texcoords_.size(), -1);
+        std::vector<int> vn_remap(normals_.size(), -1);
+
+        auto mark = [](const std::vector<int>& indices, std::vector<int>& remap) {
+            for (int idx : indices) {
+                if (idx >= 0 && static_cast<size_t>(idx) < remap.size()) remap[idx] = 0;
+            }
+        };
+        for (const auto& face : faces_) {
+            mark(face.vIdx_, v_remap);
+            mark(face.vtIdx_, vt_remap);
+            mark(face.vnIdx_, vn_remap);
+        }
+
+        // keep referenced entries in their original relative order
+        auto squeeze = [](auto& values, std::vector<int>& remap) {
+            int next = 0;
+            for (size_t i = 0; i < values.size(); ++i) {
+                if (remap[i] < 0) continue;
+                remap[i] = next;
+                values[next++] = values[i];
+            }
+            values.resize(next);
+        };
+        squeeze(vertices_, v_remap);
+        squeeze(texcoords_, vt_remap);
+        squeeze(normals_, vn_remap);
+
+        auto apply = [](std::vector<int>& indices, const std::vector<int>& remap) {
+            for (auto& idx : indices) {
+                if (idx >= 0 && static_cast<size_t>(idx) < remap.size()) idx = remap[idx];
+            }
+        };
+        for (auto& face : faces_) {
+            apply(face.vIdx_, v_remap);
+            apply(face.vtIdx_, vt_remap);
+            apply(face.vnIdx_, vn_remap);
+        }
     }
 }  // namespace mesh
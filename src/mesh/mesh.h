@@ -1,15 +1,39 @@
 #ifndef MESH_MESH_H_
 #define MESH_MESH_H_
 
+#include "groups.h"
 #include "transform.h"
 
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <iostream>
 
 namespace mesh {
 	struct Face { std::vector<int> vIdx_, vtIdx_, vnIdx_; };
 
+	// idx addresses one of count elements (relative OBJ indices are negative and do not)
+	inline bool IsValidIndex(int idx, size_t count) {
+		return idx >= 0 && static_cast<size_t>(idx) < count;
+	}
+
+	// post-transform vertex cache statistics (FIFO cache emulation)
+	struct VertexCacheStats {
+		double acmr_ = 0.0;  // average cache miss ratio: misses / triangles
+		double atvr_ = 0.0;  // average transform to vertex ratio: misses / referenced vertices
+	};
+
+	constexpr int kDefaultVertexCacheSize = 16;
+
+	// vertices_ / normals_ indices referenced by a subset of faces_, sorted and unique
+	struct VertexSelection {
+		std::vector<uint32_t> vertices_;
+		std::vector<uint32_t> normals_;
+		std::vector<uint32_t> shared_normals_;  // subset of normals_ also used by other faces
+		std::vector<FaceRange> faces_;          // the selected faces
+	};
+
 	// ֶ֧ࣨ뱣棩
 	class Mesh {
 	public:
@@ -23,12 +47,69 @@ namespace mesh {
 
 		void append(const Mesh& other);
 
+		// faces_ spans of an OBJ "o"/"g" name; nullptr when the name is unknown
+		const std::vector<FaceRange>* group_ranges(const std::string& name) const;
+
+		// vertices and normals referenced by an "o"/"g" name; built from its face ranges on
+		// first use and cached until invalidate_selections(). nullptr when the name is unknown
+		const VertexSelection* select_group(const std::string& name) const;
+
+		// transform only the selected vertices and normals. vertices shared with faces outside
+		// the selection move with it; shared normals stay and the selected faces get a
+		// transformed copy. a cached selection is updated to own the copies; other cached
+		// selections touching the same faces or normals are dropped
+		void apply_transform(const linear_algebra::Matrix4x4& matrix, const VertexSelection& selection);
+
+		// drop cached selections and normal use counts; called by every operation that
+		// rewrites face indices
+		void invalidate_selections();
+
+		// simulate a FIFO post-transform cache over the fan-triangulated faces
+		VertexCacheStats analyze_vertex_cache(int cache_size = kDefaultVertexCacheSize) const;
+
+		// reorder faces_ for post-transform cache locality (Tipsify, linear time);
+		// faces never cross a directive boundary in groups_
+		void optimize_vertex_cache(int cache_size = kDefaultVertexCacheSize);
+
+		// reorder vertices_, texcoords_ and normals_ by first use in faces_
+		void optimize_vertex_fetch();
+
+		// number of triangles after fan triangulation of faces_
+		size_t triangle_count() const;
+
+		// quadric error edge-collapse simplification down to target_triangles;
+		// uv seams and normal creases (> 30 deg) are never collapsed, borders only slide
+		// along themselves and no collapse deletes an isolated triangle, so an unwelded
+		// soup (e.g. STL) needs --weld first. polygons are triangulated. a non-zero
+		// max_working_bytes bounds the memory used besides the mesh and a few words per
+		// vertex and face: spatially sorted runs of faces are then simplified one at a time
+		// and vertices shared between runs stay put. returns the resulting triangle count
+		size_t decimate(size_t target_triangles, size_t max_working_bytes = 0);
+
+		// drop vertices_, texcoords_ and normals_ that no face references
+		void compact();
+
+		// merge vertices_ closer than epsilon (0: identical positions); corners that collapse onto
+		// their neighbour are dropped, then faces left with < 3 corners. returns the merged count
+		size_t weld(double epsilon = 0.0);
+
+		// smooth per-vertex normals, weighted by face area; normals_ becomes one per vertex
+		void recompute_normals();
+
 	public:
 		std::vector<linear_algebra::Vector3> vertices_;
 		std::vector<linear_algebra::Vector2> texcoords_;
 		std::vector<linear_algebra::Vector3> normals_;
 		std::vector<Face> faces_;
+		GroupTable groups_;
 		std::vector<std::string> other_info_str_list_;
+
+	private:
+		// corners per normals_ entry over all faces, built once for select_group
+		const std::vector<uint32_t>& normal_uses() const;
+
+		mutable std::unordered_map<std::string, VertexSelection> selections_;
+		mutable std::vector<uint32_t> normal_uses_;
 	};
 
 }  // namespace mesh
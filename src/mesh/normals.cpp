@@ -0,0 +1,44 @@
+#include "mesh.h"
+
+#include <cmath>
+#include <vector>
+
+namespace mesh {
+    void Mesh::recompute_normals() {
+        std::vector<linear_algebra::Vector3> normals(vertices_.size());
+        const int vertex_count = static_cast<int>(vertices_.size());
+        auto valid = [&](int idx) { return idx >= 0 && idx < vertex_count; };
+
+        for (auto& face : faces_) {
+            const auto& idx = face.vIdx_;
+            // Newell's method: twice the area vector, exact for planar polygons and
+            // stable for slightly non-planar ones
+            linear_algebra::Vector3 area;
+            for (size_t i = 0; i < idx.size(); ++i) {
+                const int a = idx[i];
+                const int b = idx[(i + 1) % idx.size()];
+                if (!valid(a) || !valid(b)) continue;
+                const linear_algebra::Vector3& p = vertices_[a];
+                const linear_algebra::Vector3& q = vertices_[b];
+                area.x_ += (p.y_ - q.y_) * (p.z_ + q.z_);
+                area.y_ += (p.z_ - q.z_) * (p.x_ + q.x_);
+                area.z_ += (p.x_ - q.x_) * (p.y_ + q.y_);
+            }
+            for (int v : idx) {
+                if (valid(v)) normals[v] = normals[v] + area;
+            }
+            face.vnIdx_.assign(idx.begin(), idx.end());
+            for (auto& vn_idx : face.vnIdx_) {
+                if (!valid(vn_idx)) vn_idx = -1;
+            }
+        }
+
+        // no length threshold: area weights of a millimetre scale mesh are tiny but valid
+        for (auto& n : normals) {
+            const double len = std::sqrt(n.dot(n));
+            if (len > 0.0) n = n * (1.0 / len);
+        }
+        normals_.swap(normals);
+        invalidate_selections();
+    }
+}  // namespace mesh
@@ -0,0 +1,251 @@
+#include "mesh.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace mesh {
+    namespace {
+        // vertex -> incident faces, compressed row storage
+        struct FaceAdjacency {
+            std::vector<uint32_t> offsets_;
+            std::vector<uint32_t> faces_;
+        };
+
+        FaceAdjacency BuildFaceAdjacency(const std::vector<Face>& faces, size_t vertex_count) {
+            FaceAdjacency adj;
+            adj.offsets_.assign(vertex_count + 1, 0);
+            for (const auto& face : faces) {
+                for (int v : face.vIdx_) {
+                    if (IsValidIndex(v, vertex_count)) ++adj.offsets_[v + 1];
+                }
+            }
+            for (size_t i = 0; i < vertex_count; ++i) {
+                adj.offsets_[i + 1] += adj.offsets_[i];
+            }
+            adj.faces_.resize(adj.offsets_[vertex_count]);
+            std::vector<uint32_t> cursor(adj.offsets_.begin(), adj.offsets_.end() - 1);
+            for (size_t f = 0; f < faces.size(); ++f) {
+                for (int v : faces[f].vIdx_) {
+                    if (IsValidIndex(v, vertex_count)) adj.faces_[cursor[v]++] = static_cast<uint32_t>(f);
+                }
+            }
+            return adj;
+        }
+
+        // Tipsify (Sander, Nehab, Barczak 2007): fan around the most recently cached
+        // vertex that still has live faces, fall back to a dead-end stack and then to
+        // an input-order cursor. Every vertex is fanned at most once per range, so the
+        // whole pass is linear in the number of face corners.
+        class Tipsifier {
+        public:
+            Tipsifier(const std::vector<Face>& faces, size_t vertex_count, int cache_size)
+                : faces_(faces),
+                  vertex_count_(vertex_count),
+                  adjacency_(BuildFaceAdjacency(faces, vertex_count)),
+                  live_(vertex_count, 0),
+                  time_stamp_(vertex_count, 0),
+                  emitted_(faces.size(), 1),
+                  cache_size_(cache_size),
+                  time_(static_cast<uint32_t>(cache_size) + 1) {}
+
+            // append the optimized order of faces [begin, end) to order
+            void run(size_t begin, size_t end, std::vector<uint32_t>& order) {
+                for (size_t f = begin; f < end; ++f) {
+                    emitted_[f] = 0;
+                    for (int v : faces_[f].vIdx_) {
+                        if (IsValidIndex(v, vertex_count_)) ++live_[v];
+                    }
+                }
+                dead_end_.clear();
+                cursor_face_ = begin;
+                cursor_corner_ = 0;
+                range_end_ = end;
+
+                int fanning = next_from_cursor();
+                while (fanning >= 0) {
+                    candidates_.clear();
+                    for (uint32_t k = adjacency_.offsets_[fanning]; k < adjacency_.offsets_[fanning + 1]; ++k) {
+                        const uint32_t f = adjacency_.faces_[k];
+                        if (emitted_[f]) continue;
+                        emitted_[f] = 1;
+                        order.push_back(f);
+                        for (int v : faces_[f].vIdx_) {
+                            if (!IsValidIndex(v, vertex_count_)) continue;
+                            dead_end_.push_back(v);
+                            candidates_.push_back(v);
+                            --live_[v];
+                            if (time_ - time_stamp_[v] > static_cast<uint32_t>(cache_size_)) {
+                                time_stamp_[v] = time_++;
+                            }
+                        }
+                    }
+                    fanning = next_vertex();
+                }
+
+                // faces without a single valid vertex index keep their input order
+                for (size_t f = begin; f < end; ++f) {
+                    if (!emitted_[f]) {
+                        emitted_[f] = 1;
+                        order.push_back(static_cast<uint32_t>(f));
+                    }
+                }
+            }
+
+        private:
+            int next_vertex() {
+                int best = -1;
+                int64_t best_priority = -1;
+                for (int v : candidates_) {
+                    if (live_[v] == 0) continue;
+                    // prefer the oldest vertex that will still be cached after its fan
+                    int64_t priority = 0;
+                    const int64_t age = static_cast<int64_t>(time_ - time_stamp_[v]);
+                    if (age + 2 * static_cast<int64_t>(live_[v]) <= cache_size_) {
+                        priority = age;
+                    }
+                    if (priority > best_priority) {
+                        best_priority = priority;
+                        best = v;
+                    }
+                }
+                if (best >= 0) return best;
+
+                while (!dead_end_.empty()) {
+                    const int v = dead_end_.back();
+                    dead_end_.pop_back();
+                    if (live_[v] > 0) return v;
+                }
+                return next_from_cursor();
+            }
+
+            int next_from_cursor() {
+                for (; cursor_face_ < range_end_; ++cursor_face_, cursor_corner_ = 0) {
+                    const auto& idx = faces_[cursor_face_].vIdx_;
+                    for (; cursor_corner_ < idx.size(); ++cursor_corner_) {
+                        const int v = idx[cursor_corner_];
+                        if (IsValidIndex(v, vertex_count_) && live_[v] > 0) return v;
+                    }
+                }
+                return -1;
+            }
+
+            const std::vector<Face>& faces_;
+            size_t vertex_count_;
+            FaceAdjacency adjacency_;
+            std::vector<uint32_t> live_;
+            std::vector<uint32_t> time_stamp_;
+            std::vector<uint8_t> emitted_;
+            std::vector<int> dead_end_;
+            std::vector<int> candidates_;
+            int cache_size_;
+            uint32_t time_;
+            size_t cursor_face_ = 0;
+            size_t cursor_corner_ = 0;
+            size_t range_end_ = 0;
+        };
+
+        // assign new indices by first use; unreferenced entries keep their relative order at the end
+        void FinishRemap(std::vector<int>& remap, int next) {
+            for (auto& r : remap) {
+                if (r < 0) r = next++;
+            }
+        }
+
+        template <typename T>
+        void PermuteAttribute(std::vector<T>& values, const std::vector<int>& remap) {
+            std::vector<T> permuted(values.size());
+            for (size_t i = 0; i < values.size(); ++i) {
+                permuted[remap[i]] = values[i];
+            }
+            values.swap(permuted);
+        }
+
+        void RemapIndex(int& idx, std::vector<int>& remap, int& next) {
+            if (!IsValidIndex(idx, remap.size())) return;
+            if (remap[idx] < 0) remap[idx] = next++;
+            idx = remap[idx];
+        }
+    }  // namespace
+
+    VertexCacheStats Mesh::analyze_vertex_cache(int cache_size) const {
+        VertexCacheStats stats;
+        std::vector<uint32_t> time_stamp(vertices_.size(), 0);
+        uint32_t time = static_cast<uint32_t>(cache_size) + 1;
+        uint64_t misses = 0;
+        uint64_t triangles = 0;
+
+        auto touch = [&](int v) {
+            if (!IsValidIndex(v, vertices_.size())) return;
+            if (time - time_stamp[v] > static_cast<uint32_t>(cache_size)) {
+                time_stamp[v] = time++;
+                ++misses;
+            }
+        };
+
+        for (const auto& face : faces_) {
+            const auto& idx = face.vIdx_;
+            for (size_t i = 1; i + 1 < idx.size(); ++i) {
+                touch(idx[0]);
+                touch(idx[i]);
+                touch(idx[i + 1]);
+                ++triangles;
+            }
+        }
+
+        const size_t referenced = vertices_.size() -
+            static_cast<size_t>(std::count(time_stamp.begin(), time_stamp.end(), 0u));
+        if (triangles > 0) stats.acmr_ = static_cast<double>(misses) / triangles;
+        if (referenced > 0) stats.atvr_ = static_cast<double>(misses) / referenced;
+        return stats;
+    }
+
+    void Mesh::optimize_vertex_cache(int cache_size) {
+        if (faces_.empty()) return;
+
+        // group / material directives pin face positions: optimize each span between them
+        std::vector<size_t> boundaries = { 0, faces_.size() };
+        for (const auto& directive : groups_.directives()) {
+            boundaries.push_back(std::min<size_t>(directive.face_, faces_.size()));
+        }
+        std::sort(boundaries.begin(), boundaries.end());
+        boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+        std::vector<uint32_t> order;
+        order.reserve(faces_.size());
+        Tipsifier tipsifier(faces_, vertices_.size(), cache_size);
+        for (size_t i = 0; i + 1 < boundaries.size(); ++i) {
+            tipsifier.run(boundaries[i], boundaries[i + 1], order);
+        }
+
+        std::vector<Face> reordered;
+        reordered.reserve(faces_.size());
+        for (uint32_t f : order) {
+            reordered.push_back(std::move(faces_[f]));
+        }
+        faces_.swap(reordered);
+    }
+
+    void Mesh::optimize_vertex_fetch() {
+        invalidate_selections();
+        std::vector<int> v_remap(vertices_.size(), -1);
+        std::vector<int> vt_remap(texcoords_.size(), -1);
+        std::vector<int> vn_remap(normals_.size(), -1);
+        int v_next = 0, vt_next = 0, vn_next = 0;
+
+        for (auto& face : faces_) {
+            for (auto& v_idx : face.vIdx_) RemapIndex(v_idx, v_remap, v_next);
+            for (auto& vt_idx : face.vtIdx_) RemapIndex(vt_idx, vt_remap, vt_next);
+            for (auto& vn_idx : face.vnIdx_) RemapIndex(vn_idx, vn_remap, vn_next);
+        }
+
+        FinishRemap(v_remap, v_next);
+        FinishRemap(vt_remap, vt_next);
+        FinishRemap(vn_remap, vn_next);
+
+        PermuteAttribute(vertices_, v_remap);
+        PermuteAttribute(texcoords_, vt_remap);
+        PermuteAttribute(normals_, vn_remap);
+    }
+}  // namespace mesh
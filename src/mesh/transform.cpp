@@ -25,6 +25,22 @@ namespace linear_algebra {
         return result;
     }
 
+    Matrix4x4 Matrix4x4::normal_matrix() const {
+        const auto& a = data_;
+        Matrix4x4 m;
+        m.data_ = {
+            a[5] * a[10] - a[6] * a[9], a[6] * a[8] - a[4] * a[10], a[4] * a[9] - a[5] * a[8], 0,
+            a[2] * a[9] - a[1] * a[10], a[0] * a[10] - a[2] * a[8], a[1] * a[8] - a[0] * a[9], 0,
+            a[1] * a[6] - a[2] * a[5], a[2] * a[4] - a[0] * a[6], a[0] * a[5] - a[1] * a[4], 0,
+            0, 0, 0, 1 };
+        // a mirroring matrix has det < 0; flip so normals keep facing outwards
+        const double det = a[0] * m.data_[0] + a[1] * m.data_[1] + a[2] * m.data_[2];
+        if (det < 0) {
+            for (int i = 0; i < 12; ++i) m.data_[i] = -m.data_[i];
+        }
+        return m;
+    }
+
     Vector3 Matrix4x4::operator*(const Vector3& v) const {
         double x = data_[0] * v.x_ + data_[1] * v.y_ + data_[2] * v.z_ + data_[3];
         double y = data_[4] * v.x_ + data_[5] * v.y_ + data_[6] * v.z_ + data_[7];
@@ -79,6 +79,9 @@ namespace linear_algebra {
     public:
         explicit Matrix4x4();
 
+        // row-major elements, as returned by data()
+        explicit Matrix4x4(const std::array<double, 16>& data) : data_(data) {}
+
         // λ
         static Matrix4x4 Identity();
 
@@ -90,6 +93,10 @@ namespace linear_algebra {
 
         const std::array<double, 16>& data() const { return data_; }
 
+        // matrix for normals: signed cofactor of the upper 3x3 (inverse transpose up to a
+        // positive scale), no translation; renormalize the results
+        Matrix4x4 normal_matrix() const;
+
         // ߺɳ任
         static Matrix4x4 Translate(double tx, double ty, double tz);
         static Matrix4x4 Scale(double s);
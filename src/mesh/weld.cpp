@@ -0,0 +1,126 @@
+#include "mesh.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace mesh {
+    namespace {
+        struct CellKey {
+            int64_t x_, y_, z_;
+            bool operator==(const CellKey& rhs) const { return x_ == rhs.x_ && y_ == rhs.y_ && z_ == rhs.z_; }
+        };
+
+        struct CellKeyHash {
+            size_t operator()(const CellKey& key) const {
+                uint64_t h = static_cast<uint64_t>(key.x_) * 0x9E3779B97F4A7C15ull;
+                h ^= static_cast<uint64_t>(key.y_) * 0xC2B2AE3D27D4EB4Full + (h << 6) + (h >> 2);
+                h ^= static_cast<uint64_t>(key.z_) * 0x165667B19E3779F9ull + (h << 6) + (h >> 2);
+                return static_cast<size_t>(h);
+            }
+        };
+
+        // bit pattern of the coordinate, -0.0 folded onto 0.0
+        int64_t ExactBits(double value) {
+            value += 0.0;
+            int64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+    }  // namespace
+
+    size_t Mesh::weld(double epsilon) {
+        if (vertices_.empty()) return 0;
+
+        // uniform grid of epsilon sized cells, each cell a linked list of the vertices kept in it;
+        // a merge partner is at most one cell away. epsilon 0 keys cells by exact position
+        const bool exact = !(epsilon > 0.0);
+        const double inv_cell = exact ? 0.0 : 1.0 / epsilon;
+        const double max_dist2 = epsilon * epsilon;
+        const int reach = exact ? 0 : 1;
+        auto cell_of = [&](const linear_algebra::Vector3& p) {
+            if (exact) return CellKey{ ExactBits(p.x_), ExactBits(p.y_), ExactBits(p.z_) };
+            return CellKey{ static_cast<int64_t>(std::floor(p.x_ * inv_cell)),
+                static_cast<int64_t>(std::floor(p.y_ * inv_cell)),
+                static_cast<int64_t>(std::floor(p.z_ * inv_cell)) };
+        };
+
+        std::unordered_map<CellKey, int, CellKeyHash> cell_head;
+        cell_head.reserve(vertices_.size());
+        std::vector<int> next_in_cell(vertices_.size(), -1);
+        std::vector<int> remap(vertices_.size());
+        size_t merged = 0;
+
+        for (size_t v = 0; v < vertices_.size(); ++v) {
+            const linear_algebra::Vector3& p = vertices_[v];
+            const CellKey cell = cell_of(p);
+            int partner = -1;
+            for (int dx = -reach; dx <= reach && partner < 0; ++dx) {
+                for (int dy = -reach; dy <= reach && partner < 0; ++dy) {
+                    for (int dz = -reach; dz <= reach && partner < 0; ++dz) {
+                        auto it = cell_head.find(CellKey{ cell.x_ + dx, cell.y_ + dy, cell.z_ + dz });
+                        if (it == cell_head.end()) continue;
+                        for (int k = it->second; k >= 0; k = next_in_cell[k]) {
+                            const linear_algebra::Vector3 d = vertices_[k] - p;
+                            if (exact || d.dot(d) <= max_dist2) {
+                                partner = k;
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+            if (partner >= 0) {
+                remap[v] = partner;
+                ++merged;
+                continue;
+            }
+            remap[v] = static_cast<int>(v);
+            auto inserted = cell_head.emplace(cell, static_cast<int>(v));
+            if (!inserted.second) {
+                next_in_cell[v] = inserted.first->second;
+                inserted.first->second = static_cast<int>(v);
+            }
+        }
+        if (merged == 0) return 0;
+
+        // drop corners that now repeat their predecessor, then faces left with < 3 corners
+        std::vector<uint32_t> new_first(faces_.size() + 1);
+        size_t kept = 0;
+        for (size_t f = 0; f < faces_.size(); ++f) {
+            new_first[f] = static_cast<uint32_t>(kept);
+            Face& face = faces_[f];
+            for (auto& v_idx : face.vIdx_) {
+                if (v_idx >= 0 && static_cast<size_t>(v_idx) < remap.size()) v_idx = remap[v_idx];
+            }
+            const size_t n = face.vIdx_.size();
+            auto repeats = [&](size_t i) { return n > 1 && face.vIdx_[i] == face.vIdx_[(i + n - 1) % n]; };
+            size_t repeated = 0;
+            for (size_t i = 0; i < n; ++i) repeated += repeats(i);
+            if (repeated == 0) {
+                if (kept != f) faces_[kept] = std::move(face);
+                ++kept;
+                continue;
+            }
+            if (n - repeated < 3) continue;
+
+            Face welded;
+            for (size_t i = 0; i < n; ++i) {
+                if (repeats(i)) continue;
+                welded.vIdx_.push_back(face.vIdx_[i]);
+                welded.vtIdx_.push_back(i < face.vtIdx_.size() ? face.vtIdx_[i] : -1);
+                welded.vnIdx_.push_back(i < face.vnIdx_.size() ? face.vnIdx_[i] : -1);
+            }
+            faces_[kept++] = std::move(welded);
+        }
+        new_first[faces_.size()] = static_cast<uint32_t>(kept);
+        faces_.resize(kept);
+        groups_.remap_faces(new_first);
+
+        invalidate_selections();
+        compact();
+        return merged;
+    }
+}  // namespace mesh
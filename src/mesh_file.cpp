@@ -0,0 +1,81 @@
+#include "mesh_file.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+
+#include "mesh/mesh.h"
+#include "obj_file.h"
+#include "ply_file.h"
+#include "quantized_file.h"
+#include "stl_file.h"
+
+namespace file {
+    MeshFormat FormatFromPath(const std::string& file_path) {
+        const size_t pos = file_path.find_last_of('.');
+        if (pos == std::string::npos) return MeshFormat::kUnknown;
+        return FormatFromName(file_path.substr(pos + 1));
+    }
+
+    MeshFormat FormatFromName(std::string name) {
+        std::transform(name.begin(), name.end(), name.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        if (name == "obj") return MeshFormat::kObj;
+        if (name == "ply") return MeshFormat::kPly;
+        if (name == "stl") return MeshFormat::kStl;
+        if (name == "qmesh") return MeshFormat::kQuantized;
+        return MeshFormat::kUnknown;
+    }
+
+    CMeshFile::CMeshFile() {
+        mesh_ = std::make_shared<mesh::Mesh>();
+    }
+
+    std::shared_ptr<mesh::Mesh> CMeshFile::mesh()
+    {
+        return mesh_;
+    }
+
+    void CMeshFile::set_mesh(std::shared_ptr<mesh::Mesh> mesh)
+    {
+        mesh_ = std::move(mesh);
+    }
+
+    void CMeshFile::detach_mesh()
+    {
+        mesh_ = std::make_shared<mesh::Mesh>(*mesh_);
+    }
+
+    std::shared_ptr<CMeshFile> CreateMeshFile(MeshFormat format) {
+        switch (format) {
+        case MeshFormat::kObj: return std::make_shared<CObjFile>();
+        case MeshFormat::kPly: return std::make_shared<CPlyFile>();
+        case MeshFormat::kStl: return std::make_shared<CStlFile>();
+        case MeshFormat::kQuantized: return std::make_shared<CQuantizedFile>();
+        default: return nullptr;
+        }
+    }
+
+    std::shared_ptr<CMeshFile> CreateWriter(const std::shared_ptr<CMeshFile>& source, MeshFormat format) {
+        if (source->format() == format) return source;
+        std::shared_ptr<CMeshFile> writer = CreateMeshFile(format);
+        if (writer) writer->set_mesh(source->mesh());
+        return writer;
+    }
+
+    std::vector<const mesh::Face*> WritableFaces(const mesh::Mesh& mesh, const char* format_name) {
+        std::vector<const mesh::Face*> faces;
+        faces.reserve(mesh.faces_.size());
+        for (const auto& face : mesh.faces_) {
+            const bool valid = std::all_of(face.vIdx_.begin(), face.vIdx_.end(),
+                [&](int v) { return mesh::IsValidIndex(v, mesh.vertices_.size()); });
+            if (valid) faces.push_back(&face);
+        }
+        if (faces.size() != mesh.faces_.size()) {
+            std::cerr << "Warning: " << format_name << " output skips " << (mesh.faces_.size() - faces.size())
+                << " faces with out of range vertex indices\n";
+        }
+        return faces;
+    }
+}
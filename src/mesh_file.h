@@ -0,0 +1,86 @@
+#ifndef MESH_FILE_H_
+#define MESH_FILE_H_
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mesh {
+	class Mesh;
+	struct Face;
+}
+
+namespace file {
+	class CFileBuffer;
+
+	enum class MeshFormat {
+		kUnknown,
+		kObj,
+		kPly,  // binary little endian
+		kStl,  // binary
+		kQuantized,  // .qmesh, see CQuantizedFile
+	};
+
+	// format from the file extension (case insensitive)
+	MeshFormat FormatFromPath(const std::string& file_path);
+
+	// format from its extension without the dot: "obj", "ply", "stl", "qmesh" (case insensitive)
+	MeshFormat FormatFromName(std::string name);
+
+	// common interface of all mesh readers / writers
+	class CMeshFile {
+	public:
+		explicit CMeshFile();
+		virtual ~CMeshFile() = default;
+
+		virtual bool read(const std::string& file_path) = 0;
+		virtual bool write(const std::string& file_path) const = 0;
+
+		// the same bytes as the file, for "-" (stdin / stdout); binary formats read the
+		// whole stream before parsing
+		virtual bool read(std::istream& in) = 0;
+		virtual bool write(std::ostream& out) const = 0;
+
+		// same reader / writer settings with a deep copy of the mesh
+		virtual std::shared_ptr<CMeshFile> clone() const = 0;
+
+		virtual MeshFormat format() const = 0;
+
+		std::shared_ptr<mesh::Mesh> mesh();
+		void set_mesh(std::shared_ptr<mesh::Mesh> mesh);
+
+	protected:
+		// replace mesh_ by a deep copy of it
+		void detach_mesh();
+
+		std::shared_ptr<mesh::Mesh> mesh_ = nullptr;
+	};
+
+	// clone() and format() of a concrete reader / writer:
+	// class CObjFile : public CMeshFileBase<CObjFile, MeshFormat::kObj>
+	template <typename Derived, MeshFormat kFormat>
+	class CMeshFileBase : public CMeshFile {
+	public:
+		std::shared_ptr<CMeshFile> clone() const override {
+			auto copy = std::make_shared<Derived>(static_cast<const Derived&>(*this));
+			copy->detach_mesh();
+			return copy;
+		}
+
+		MeshFormat format() const override { return kFormat; }
+	};
+
+	// nullptr for kUnknown
+	std::shared_ptr<CMeshFile> CreateMeshFile(MeshFormat format);
+
+	// writer for format sharing source's mesh: source itself when it has that format, so
+	// format specific extras (OBJ comments, qmesh bit depths) survive; nullptr for kUnknown
+	std::shared_ptr<CMeshFile> CreateWriter(const std::shared_ptr<CMeshFile>& source, MeshFormat format);
+
+	// faces whose vertex indices all address mesh.vertices_, for writers that dereference
+	// them (relative OBJ indices do not); warns on std::cerr with the skipped count
+	std::vector<const mesh::Face*> WritableFaces(const mesh::Mesh& mesh, const char* format_name);
+}
+
+#endif // MESH_FILE_H_
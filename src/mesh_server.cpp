@@ -0,0 +1,723 @@
+#include "mesh_server.h"
+
+#include <iostream>
+
+#ifndef _WIN32
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <csignal>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "mesh/mesh.h"
+#include "mesh_file.h"
+#include "quantized_file.h"
+#include "transform_options.h"
+
+namespace mesh_app {
+    namespace {
+        constexpr size_t kMaxLineBytes = size_t(1) << 20;
+        constexpr size_t kLatencySamples = 4096;
+        constexpr int kMaxJsonDepth = 16;
+
+        // just enough JSON for the request lines: numbers and literals keep their source text
+        struct JsonValue {
+            enum class Type { kNull, kBool, kNumber, kString, kArray, kObject };
+            Type type_ = Type::kNull;
+            std::string text_;
+            std::vector<JsonValue> items_;
+            std::vector<std::pair<std::string, JsonValue>> members_;
+
+            const JsonValue* find(const std::string& key) const {
+                for (const auto& member : members_) {
+                    if (member.first == key) return &member.second;
+                }
+                return nullptr;
+            }
+        };
+
+        class JsonReader {
+        public:
+            explicit JsonReader(const std::string& text) : text_(text) {}
+
+            bool parse(JsonValue& value) {
+                if (!parse_value(value, 0)) return false;
+                skip_space();
+                return pos_ == text_.size();
+            }
+
+        private:
+            void skip_space() {
+                while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) ++pos_;
+            }
+
+            bool parse_value(JsonValue& value, int depth) {
+                if (depth > kMaxJsonDepth) return false;
+                skip_space();
+                if (pos_ >= text_.size()) return false;
+                const char c = text_[pos_];
+                if (c == '{') return parse_object(value, depth);
+                if (c == '[') return parse_array(value, depth);
+                if (c == '"') {
+                    value.type_ = JsonValue::Type::kString;
+                    return parse_string(value.text_);
+                }
+                return parse_literal(value);
+            }
+
+            bool parse_object(JsonValue& value, int depth) {
+                value.type_ = JsonValue::Type::kObject;
+                ++pos_;
+                skip_space();
+                if (pos_ < text_.size() && text_[pos_] == '}') { ++pos_; return true; }
+                while (true) {
+                    skip_space();
+                    std::string key;
+                    if (pos_ >= text_.size() || text_[pos_] != '"' || !parse_string(key)) return false;
+                    skip_space();
+                    if (pos_ >= text_.size() || text_[pos_++] != ':') return false;
+                    value.members_.emplace_back(std::move(key), JsonValue());
+                    if (!parse_value(value.members_.back().second, depth + 1)) return false;
+                    skip_space();
+                    if (pos_ >= text_.size()) return false;
+                    const char c = text_[pos_++];
+                    if (c == '}') return true;
+                    if (c != ',') return false;
+                }
+            }
+
+            bool parse_array(JsonValue& value, int depth) {
+                value.type_ = JsonValue::Type::kArray;
+                ++pos_;
+                skip_space();
+                if (pos_ < text_.size() && text_[pos_] == ']') { ++pos_; return true; }
+                while (true) {
+                    value.items_.emplace_back();
+                    if (!parse_value(value.items_.back(), depth + 1)) return false;
+                    skip_space();
+                    if (pos_ >= text_.size()) return false;
+                    const char c = text_[pos_++];
+                    if (c == ']') return true;
+                    if (c != ',') return false;
+                }
+            }
+
+            bool parse_string(std::string& out) {
+                ++pos_;
+                while (pos_ < text_.size()) {
+                    const char c = text_[pos_++];
+                    if (c == '"') return true;
+                    if (c != '\\') { out += c; continue; }
+                    if (pos_ >= text_.size()) return false;
+                    const char e = text_[pos_++];
+                    switch (e) {
+                    case '"': case '\\': case '/': out += e; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'n': out += '\n'; break;
+                    case 'r': out += '\r'; break;
+                    case 't': out += '\t'; break;
+                    case 'u': {
+                        if (pos_ + 4 > text_.size() ||
+                            !std::all_of(text_.begin() + pos_, text_.begin() + pos_ + 4,
+                                [](unsigned char h) { return std::isxdigit(h) != 0; })) {
+                            return false;
+                        }
+                        const unsigned code = static_cast<unsigned>(std::stoul(text_.substr(pos_, 4), nullptr, 16));
+                        pos_ += 4;
+                        // BMP only, encoded as UTF-8
+                        if (code < 0x80) {
+                            out += static_cast<char>(code);
+                        }
+                        else if (code < 0x800) {
+                            out += static_cast<char>(0xC0 | (code >> 6));
+                            out += static_cast<char>(0x80 | (code & 0x3F));
+                        }
+                        else {
+                            out += static_cast<char>(0xE0 | (code >> 12));
+                            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                            out += static_cast<char>(0x80 | (code & 0x3F));
+                        }
+                        break;
+                    }
+                    default: return false;
+                    }
+                }
+                return false;
+            }
+
+            bool parse_literal(JsonValue& value) {
+                const size_t begin = pos_;
+                while (pos_ < text_.size() && (std::isalnum(static_cast<unsigned char>(text_[pos_])) ||
+                    text_[pos_] == '-' || text_[pos_] == '+' || text_[pos_] == '.')) {
+                    ++pos_;
+                }
+                value.text_ = text_.substr(begin, pos_ - begin);
+                if (value.text_ == "true" || value.text_ == "false") {
+                    value.type_ = JsonValue::Type::kBool;
+                    return true;
+                }
+                if (value.text_ == "null") {
+                    value.type_ = JsonValue::Type::kNull;
+                    return true;
+                }
+                if (value.text_.empty()) return false;
+                try {
+                    size_t used = 0;
+                    std::stod(value.text_, &used);
+                    if (used != value.text_.size()) return false;
+                }
+                catch (const std::exception&) {
+                    return false;
+                }
+                value.type_ = JsonValue::Type::kNumber;
+                return true;
+            }
+
+            const std::string& text_;
+            size_t pos_ = 0;
+        };
+
+        std::string JsonString(const std::string& s) {
+            std::string out = "\"";
+            for (const char c : s) {
+                switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char buf[8];
+                        std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                        out += buf;
+                    }
+                    else {
+                        out += c;
+                    }
+                }
+            }
+            return out + "\"";
+        }
+
+        // echo of the request id, "null" when absent
+        std::string JsonId(const JsonValue* id) {
+            if (!id) return "null";
+            if (id->type_ == JsonValue::Type::kString) return JsonString(id->text_);
+            if (id->type_ == JsonValue::Type::kNumber) return id->text_;
+            return "null";
+        }
+
+        // heap footprint of the mesh arrays, close enough for the cache budget
+        size_t MeshBytes(const mesh::Mesh& mesh) {
+            size_t bytes = sizeof(mesh::Mesh)
+                + mesh.vertices_.capacity() * sizeof(linear_algebra::Vector3)
+                + mesh.texcoords_.capacity() * sizeof(linear_algebra::Vector2)
+                + mesh.normals_.capacity() * sizeof(linear_algebra::Vector3)
+                + mesh.faces_.capacity() * sizeof(mesh::Face);
+            for (const auto& face : mesh.faces_) {
+                bytes += (face.vIdx_.capacity() + face.vtIdx_.capacity() + face.vnIdx_.capacity()) * sizeof(int);
+            }
+            return bytes;
+        }
+
+        // parsed input meshes, least recently used first out once over budget
+        class MeshCache {
+        public:
+            struct Stats {
+                uint64_t hits_ = 0;
+                uint64_t misses_ = 0;
+                size_t entries_ = 0;
+                size_t bytes_ = 0;
+            };
+
+            explicit MeshCache(size_t budget) : budget_(budget) {}
+
+            // private copy of the parsed file; hit tells whether parsing was skipped
+            std::shared_ptr<file::CMeshFile> acquire(const std::string& path, bool& hit, std::string& error) {
+                std::error_code ec;
+                const auto size = std::filesystem::file_size(path, ec);
+                const auto mtime = std::filesystem::last_write_time(path, ec);
+                if (ec) {
+                    error = "cannot stat " + path + ": " + ec.message();
+                    return nullptr;
+                }
+
+                std::shared_ptr<const file::CMeshFile> cached;
+                std::shared_future<std::shared_ptr<const file::CMeshFile>> in_flight;
+                std::promise<std::shared_ptr<const file::CMeshFile>> loading;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    auto it = index_.find(path);
+                    if (it != index_.end()) {
+                        if (it->second->size_ == size && it->second->mtime_ == mtime) {
+                            lru_.splice(lru_.begin(), lru_, it->second);
+                            cached = it->second->file_;
+                        }
+                        else {
+                            erase(it->second);
+                        }
+                    }
+                    // a concurrent miss on the same path is already parsing it: wait for that one
+                    auto pending = loading_.find(path);
+                    if (!cached && pending != loading_.end()) in_flight = pending->second;
+                    if (!cached && !in_flight.valid()) loading_.emplace(path, loading.get_future().share());
+                    if (cached || in_flight.valid()) {
+                        ++stats_.hits_;
+                    }
+                    else {
+                        ++stats_.misses_;
+                    }
+                }
+                if (in_flight.valid()) {
+                    cached = in_flight.get();
+                    if (!cached) error = "failed to load " + path;
+                }
+                hit = cached != nullptr;
+                if (cached) return cached->clone();
+                if (in_flight.valid()) return nullptr;
+
+                // waiters get the parse result on every exit, a throwing reader included;
+                // nullptr unless the load succeeded
+                struct Publish {
+                    MeshCache& cache_;
+                    const std::string& path_;
+                    std::promise<std::shared_ptr<const file::CMeshFile>>& promise_;
+                    std::shared_ptr<const file::CMeshFile> result_;
+                    ~Publish() {
+                        {
+                            std::lock_guard<std::mutex> lock(cache_.mutex_);
+                            cache_.loading_.erase(path_);
+                        }
+                        promise_.set_value(result_);
+                    }
+                } publish{ *this, path, loading, nullptr };
+
+                std::shared_ptr<file::CMeshFile> loaded = file::CreateMeshFile(file::FormatFromPath(path));
+                if (!loaded) {
+                    error = "unsupported input extension: " + path;
+                }
+                else if (!loaded->read(path)) {
+                    error = "failed to load " + path;
+                    loaded = nullptr;
+                }
+
+                std::shared_ptr<file::CMeshFile> copy = loaded ? loaded->clone() : nullptr;
+                const size_t bytes = loaded ? MeshBytes(*loaded->mesh()) : 0;
+                if (loaded && bytes <= budget_) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    lru_.push_front(Entry{ path, size, mtime, loaded, bytes });
+                    index_[path] = lru_.begin();
+                    stats_.bytes_ += bytes;
+                    while (stats_.bytes_ > budget_) erase(std::prev(lru_.end()));
+                }
+                publish.result_ = loaded;
+                return copy;
+            }
+
+            Stats stats() const {
+                std::lock_guard<std::mutex> lock(mutex_);
+                Stats stats = stats_;
+                stats.entries_ = lru_.size();
+                return stats;
+            }
+
+            size_t budget() const { return budget_; }
+
+        private:
+            struct Entry {
+                std::string path_;
+                uintmax_t size_;
+                std::filesystem::file_time_type mtime_;
+                std::shared_ptr<const file::CMeshFile> file_;
+                size_t bytes_;
+            };
+
+            void erase(std::list<Entry>::iterator it) {
+                stats_.bytes_ -= it->bytes_;
+                index_.erase(it->path_);
+                lru_.erase(it);
+            }
+
+            const size_t budget_;
+            mutable std::mutex mutex_;
+            std::list<Entry> lru_;
+            std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+            std::unordered_map<std::string, std::shared_future<std::shared_ptr<const file::CMeshFile>>> loading_;
+            Stats stats_;
+        };
+
+        // one client socket; responses from different workers are serialized per line
+        class Connection {
+        public:
+            explicit Connection(int fd) : fd_(fd) {}
+            ~Connection() { close(fd_); }
+
+            int fd() const { return fd_; }
+
+            void send_line(const std::string& line) {
+                const std::string data = line + "\n";
+                std::lock_guard<std::mutex> lock(write_mutex_);
+                size_t sent = 0;
+                while (sent < data.size()) {
+                    const ssize_t n = ::send(fd_, data.data() + sent, data.size() - sent, 0);
+                    if (n <= 0) return;  // client went away, drop the response
+                    sent += static_cast<size_t>(n);
+                }
+            }
+
+        private:
+            int fd_;
+            std::mutex write_mutex_;
+        };
+
+        class Server {
+        public:
+            explicit Server(const ServerOptions& options)
+                : options_(options), cache_(options.cache_budget_bytes_) {}
+
+            int run();
+
+        private:
+            struct PendingJob {
+                std::shared_ptr<Connection> connection_;
+                JsonValue request_;
+                std::chrono::steady_clock::time_point queued_;
+            };
+
+            struct ConnectionThread {
+                std::thread thread_;
+                std::weak_ptr<Connection> connection_;
+                std::shared_ptr<std::atomic<bool>> done_;
+            };
+
+            void serve_connection(std::shared_ptr<Connection> connection, std::shared_ptr<std::atomic<bool>> done);
+            void handle_line(const std::shared_ptr<Connection>& connection, const std::string& line);
+            void worker_loop();
+            bool run_job(const JsonValue& request, std::string& fields, std::string& error);
+            std::string stats_json(const std::string& id);
+            void record_latency(double ms, bool ok);
+            void reap_connections(bool all);
+
+            const ServerOptions options_;
+            MeshCache cache_;
+            std::atomic<bool> stopping_{ false };
+
+            std::mutex queue_mutex_;
+            std::condition_variable queue_cv_;
+            std::deque<PendingJob> queue_;
+            size_t active_ = 0;
+
+            std::mutex stats_mutex_;
+            std::vector<double> latencies_ms_;  // ring of the most recent kLatencySamples
+            size_t latency_next_ = 0;
+            uint64_t completed_ = 0;
+            uint64_t failed_ = 0;
+
+            std::vector<ConnectionThread> connections_;
+        };
+
+        int Server::run() {
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            if (options_.socket_path_.size() >= sizeof(addr.sun_path)) {
+                std::cerr << "❌ Error: socket path too long: " << options_.socket_path_ << "\n";
+                return 1;
+            }
+            std::copy(options_.socket_path_.begin(), options_.socket_path_.end(), addr.sun_path);
+
+            const int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (listen_fd < 0) {
+                std::perror("socket");
+                return 1;
+            }
+            unlink(options_.socket_path_.c_str());
+            if (bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listen_fd, 64) != 0) {
+                std::cerr << "❌ Error: cannot listen on " << options_.socket_path_ << "\n";
+                close(listen_fd);
+                return 1;
+            }
+            std::signal(SIGPIPE, SIG_IGN);
+
+            const int workers = options_.workers_ > 0
+                ? options_.workers_
+                : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+            std::vector<std::thread> pool;
+            for (int i = 0; i < workers; ++i) {
+                pool.emplace_back(&Server::worker_loop, this);
+            }
+            std::cout << "✅ Serving on " << options_.socket_path_ << " with " << workers
+                << " workers, mesh cache budget " << (options_.cache_budget_bytes_ >> 20) << " MB\n";
+
+            while (!stopping_) {
+                pollfd pfd{ listen_fd, POLLIN, 0 };
+                if (poll(&pfd, 1, 200) <= 0) continue;
+                const int fd = accept(listen_fd, nullptr, nullptr);
+                if (fd < 0) continue;
+                reap_connections(false);
+                auto connection = std::make_shared<Connection>(fd);
+                auto done = std::make_shared<std::atomic<bool>>(false);
+                connections_.push_back(ConnectionThread{
+                    std::thread(&Server::serve_connection, this, connection, done), connection, done });
+            }
+
+            close(listen_fd);
+            unlink(options_.socket_path_.c_str());
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex_);
+                queue_cv_.notify_all();
+            }
+            for (auto& thread : pool) thread.join();
+            reap_connections(true);
+            std::cout << "✅ Server stopped after " << completed_ << " jobs (" << failed_ << " failed)\n";
+            return 0;
+        }
+
+        void Server::reap_connections(bool all) {
+            for (auto it = connections_.begin(); it != connections_.end();) {
+                if (all) {
+                    if (auto connection = it->connection_.lock()) shutdown(connection->fd(), SHUT_RDWR);
+                }
+                if (all || *it->done_) {
+                    it->thread_.join();
+                    it = connections_.erase(it);
+                }
+                else {
+                    ++it;
+                }
+            }
+        }
+
+        void Server::serve_connection(std::shared_ptr<Connection> connection, std::shared_ptr<std::atomic<bool>> done) {
+            std::string pending;
+            char buffer[64 * 1024];
+            while (!stopping_) {
+                const ssize_t n = recv(connection->fd(), buffer, sizeof(buffer), 0);
+                if (n <= 0) break;
+                pending.append(buffer, static_cast<size_t>(n));
+                size_t start = 0;
+                for (size_t eol; (eol = pending.find('\n', start)) != std::string::npos; start = eol + 1) {
+                    handle_line(connection, pending.substr(start, eol - start));
+                }
+                pending.erase(0, start);
+                if (pending.size() > kMaxLineBytes) {
+                    connection->send_line("{\"id\":null,\"ok\":false,\"error\":\"request line too long\"}");
+                    break;
+                }
+            }
+            *done = true;
+        }
+
+        void Server::handle_line(const std::shared_ptr<Connection>& connection, const std::string& line) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos) return;
+            JsonValue request;
+            if (!JsonReader(line).parse(request) || request.type_ != JsonValue::Type::kObject) {
+                connection->send_line("{\"id\":null,\"ok\":false,\"error\":\"malformed JSON request\"}");
+                return;
+            }
+            const std::string id = JsonId(request.find("id"));
+            const JsonValue* cmd = request.find("cmd");
+            if (cmd && cmd->text_ == "stats") {
+                connection->send_line(stats_json(id));
+                return;
+            }
+            if (cmd && cmd->text_ == "shutdown") {
+                stopping_ = true;
+                connection->send_line("{\"id\":" + id + ",\"ok\":true}");
+                return;
+            }
+            if (cmd && cmd->text_ != "job") {
+                connection->send_line("{\"id\":" + id + ",\"ok\":false,\"error\":" +
+                    JsonString("unknown cmd '" + cmd->text_ + "'") + "}");
+                return;
+            }
+            if (stopping_) {
+                connection->send_line("{\"id\":" + id + ",\"ok\":false,\"error\":\"server is shutting down\"}");
+                return;
+            }
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            queue_.push_back(PendingJob{ connection, std::move(request), std::chrono::steady_clock::now() });
+            queue_cv_.notify_one();
+        }
+
+        void Server::worker_loop() {
+            while (true) {
+                PendingJob job;
+                {
+                    std::unique_lock<std::mutex> lock(queue_mutex_);
+                    queue_cv_.wait_for(lock, std::chrono::milliseconds(200),
+                        [this]() { return !queue_.empty() || stopping_; });
+                    if (queue_.empty()) {
+                        if (stopping_) return;
+                        continue;
+                    }
+                    job = std::move(queue_.front());
+                    queue_.pop_front();
+                    ++active_;
+                }
+
+                // a throwing reader or stage fails this job only, never the daemon
+                std::string fields, error;
+                bool ok = false;
+                try {
+                    ok = run_job(job.request_, fields, error);
+                }
+                catch (const std::exception& e) {
+                    error = std::string("job failed: ") + e.what();
+                }
+                const double ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - job.queued_).count();
+                record_latency(ms, ok);
+
+                {
+                    std::lock_guard<std::mutex> lock(queue_mutex_);
+                    --active_;
+                }
+
+                std::ostringstream response;
+                response << "{\"id\":" << JsonId(job.request_.find("id"));
+                if (ok) {
+                    response << ",\"ok\":true" << fields << ",\"ms\":" << ms << "}";
+                }
+                else {
+                    response << ",\"ok\":false,\"error\":" << JsonString(error) << "}";
+                }
+                job.connection_->send_line(response.str());
+            }
+        }
+
+        // true with extra response fields (",key:value..."), false with a message in error
+        bool Server::run_job(const JsonValue& request, std::string& fields, std::string& error) {
+            auto fail = [&](const std::string& message) {
+                error = message;
+                return false;
+            };
+            const JsonValue* input = request.find("input");
+            const JsonValue* output = request.find("output");
+            if (!input || input->type_ != JsonValue::Type::kString ||
+                !output || output->type_ != JsonValue::Type::kString) {
+                return fail("job needs string fields \"input\" and \"output\"");
+            }
+
+            std::vector<std::string> args;
+            if (const JsonValue* ops = request.find("ops")) {
+                if (ops->type_ != JsonValue::Type::kArray) return fail("\"ops\" must be an array");
+                for (const auto& op : ops->items_) args.push_back(op.text_);
+            }
+            JobOptions options;
+            if (!ParseJobOptions(args, options, error)) return false;
+
+            const file::MeshFormat output_format = file::FormatFromPath(output->text_);
+            if (output_format == file::MeshFormat::kUnknown) {
+                return fail("unsupported output extension: " + output->text_);
+            }
+
+            bool hit = false;
+            std::shared_ptr<file::CMeshFile> mesh_file = cache_.acquire(input->text_, hit, error);
+            if (!mesh_file) return false;
+            if (!ApplyJobOptions(*mesh_file->mesh(), options, error)) return false;
+
+            std::shared_ptr<file::CMeshFile> output_file = file::CreateWriter(mesh_file, output_format);
+            if (auto quantized = std::dynamic_pointer_cast<file::CQuantizedFile>(output_file)) {
+                quantized->set_position_bits(options.quant_bits_);
+            }
+            if (!output_file->write(output->text_)) return fail("failed to write " + output->text_);
+
+            std::ostringstream text;
+            text << ",\"cache\":\"" << (hit ? "hit" : "miss") << "\""
+                << ",\"vertices\":" << mesh_file->mesh()->vertices().size()
+                << ",\"triangles\":" << mesh_file->mesh()->triangle_count();
+            fields = text.str();
+            return true;
+        }
+
+        void Server::record_latency(double ms, bool ok) {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            if (latencies_ms_.size() < kLatencySamples) {
+                latencies_ms_.push_back(ms);
+            }
+            else {
+                latencies_ms_[latency_next_] = ms;
+            }
+            latency_next_ = (latency_next_ + 1) % kLatencySamples;
+            ++completed_;
+            if (!ok) ++failed_;
+        }
+
+        std::string Server::stats_json(const std::string& id) {
+            size_t queued = 0, active = 0;
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex_);
+                queued = queue_.size();
+                active = active_;
+            }
+            std::vector<double> samples;
+            uint64_t completed = 0, failed = 0;
+            {
+                std::lock_guard<std::mutex> lock(stats_mutex_);
+                samples = latencies_ms_;
+                completed = completed_;
+                failed = failed_;
+            }
+            std::sort(samples.begin(), samples.end());
+            auto percentile = [&](double p) {
+                if (samples.empty()) return 0.0;
+                const size_t rank = static_cast<size_t>(p * (samples.size() - 1) + 0.5);
+                return samples[rank];
+            };
+            const MeshCache::Stats cache = cache_.stats();
+            const uint64_t lookups = cache.hits_ + cache.misses_;
+
+            std::ostringstream text;
+            text << "{\"id\":" << id << ",\"ok\":true"
+                << ",\"queue_depth\":" << queued << ",\"active\":" << active
+                << ",\"completed\":" << completed << ",\"failed\":" << failed
+                << ",\"latency_ms\":{\"samples\":" << samples.size()
+                << ",\"p50\":" << percentile(0.50) << ",\"p90\":" << percentile(0.90)
+                << ",\"p99\":" << percentile(0.99) << "}"
+                << ",\"cache\":{\"hits\":" << cache.hits_ << ",\"misses\":" << cache.misses_
+                << ",\"hit_rate\":" << (lookups ? double(cache.hits_) / lookups : 0.0)
+                << ",\"entries\":" << cache.entries_ << ",\"bytes\":" << cache.bytes_
+                << ",\"budget\":" << cache_.budget() << "}}";
+            return text.str();
+        }
+    }  // namespace
+
+    int RunServer(const ServerOptions& options) {
+        Server server(options);
+        return server.run();
+    }
+}
+
+#else  // _WIN32
+
+namespace mesh_app {
+    int RunServer(const ServerOptions&) {
+        std::cerr << "❌ Error: --serve is unsupported on this platform (needs unix domain sockets)\n";
+        return 1;
+    }
+}
+
+#endif
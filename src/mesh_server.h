@@ -0,0 +1,25 @@
+#ifndef MESH_APP_MESH_SERVER_H_
+#define MESH_APP_MESH_SERVER_H_
+
+#include <cstddef>
+#include <string>
+
+namespace mesh_app {
+	struct ServerOptions {
+		std::string socket_path_;
+		int workers_ = 0;  // 0: one per hardware thread
+		size_t cache_budget_bytes_ = size_t(512) << 20;
+	};
+
+	// Long running worker for --serve. Listens on a unix domain socket and reads one JSON
+	// request per line, answering each with one JSON line:
+	//   {"id": 1, "input": "a.obj", "output": "b.ply", "ops": ["--translate", 1, 0, 0]}
+	//   {"cmd": "stats"}     queue depth, latency percentiles, parsed mesh cache hit rate
+	//   {"cmd": "shutdown"}  finish queued jobs, then exit
+	// Jobs run on a shared worker pool; parsed inputs stay in an LRU cache bounded by
+	// cache_budget_bytes_ and are reused while the file's size and mtime are unchanged.
+	// POSIX only. Returns the process exit code.
+	int RunServer(const ServerOptions& options);
+}
+
+#endif // MESH_APP_MESH_SERVER_H_
@@ -0,0 +1,289 @@
+#include "meshtransform_c.h"
+
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <memory>
+#include <new>
+#include <string>
+
+#include "mesh/mesh.h"
+#include "mesh_file.h"
+
+struct mt_mesh {
+    // reader of the last load, keeps format extras; a blank OBJ file before that
+    std::shared_ptr<file::CMeshFile> source_ = file::CreateMeshFile(file::MeshFormat::kObj);
+    std::shared_ptr<mesh::Mesh> mesh_ = source_->mesh();
+};
+
+namespace {
+    using linear_algebra::Matrix4x4;
+
+    thread_local std::string g_last_error;
+
+    mt_status Fail(mt_status status, const std::string& message) {
+        g_last_error = message;
+        return status;
+    }
+
+    Matrix4x4 ToMatrix(const mt_matrix* m) {
+        std::array<double, 16> data;
+        std::copy(m->m, m->m + 16, data.begin());
+        return Matrix4x4(data);
+    }
+
+    void FromMatrix(const Matrix4x4& matrix, mt_matrix* m) {
+        std::copy(matrix.data().begin(), matrix.data().end(), m->m);
+    }
+
+    // m = op * m
+    void Compose(mt_matrix* m, const Matrix4x4& op) {
+        if (m) FromMatrix(op * ToMatrix(m), m);
+    }
+
+    // runs fn, mapping C++ exceptions onto status codes
+    template <typename Fn>
+    mt_status Guard(Fn&& fn) {
+        try {
+            g_last_error.clear();
+            return fn();
+        }
+        catch (const std::bad_alloc&) {
+            return Fail(MT_ERROR_OUT_OF_MEMORY, "out of memory");
+        }
+        catch (const std::exception& e) {
+            return Fail(MT_ERROR_INVALID_ARGUMENT, e.what());
+        }
+    }
+
+    template <typename T>
+    mt_status TransformPoints(T* xyz, size_t count, size_t stride_bytes, const mt_matrix* m) {
+        if ((!xyz && count) || !m) return Fail(MT_ERROR_INVALID_ARGUMENT, "null buffer or matrix");
+        const size_t stride = stride_bytes ? stride_bytes : 3 * sizeof(T);
+        const Matrix4x4 matrix = ToMatrix(m);
+        char* base = reinterpret_cast<char*>(xyz);
+        for (size_t i = 0; i < count; ++i) {
+            T* p = reinterpret_cast<T*>(base + i * stride);
+            const linear_algebra::Vector3 v = matrix * linear_algebra::Vector3(p[0], p[1], p[2]);
+            p[0] = static_cast<T>(v.x_);
+            p[1] = static_cast<T>(v.y_);
+            p[2] = static_cast<T>(v.z_);
+        }
+        return MT_OK;
+    }
+
+    template <typename T>
+    mt_status TransformNormals(T* xyz, size_t count, size_t stride_bytes, const mt_matrix* m) {
+        if ((!xyz && count) || !m) return Fail(MT_ERROR_INVALID_ARGUMENT, "null buffer or matrix");
+        const size_t stride = stride_bytes ? stride_bytes : 3 * sizeof(T);
+        const Matrix4x4 normal_matrix = ToMatrix(m).normal_matrix();
+        char* base = reinterpret_cast<char*>(xyz);
+        for (size_t i = 0; i < count; ++i) {
+            T* p = reinterpret_cast<T*>(base + i * stride);
+            const linear_algebra::Vector3 n =
+                (normal_matrix * linear_algebra::Vector3(p[0], p[1], p[2])).normalized();
+            p[0] = static_cast<T>(n.x_);
+            p[1] = static_cast<T>(n.y_);
+            p[2] = static_cast<T>(n.z_);
+        }
+        return MT_OK;
+    }
+}  // namespace
+
+extern "C" {
+
+int mt_api_version(void) {
+    return MT_API_VERSION;
+}
+
+const char* mt_last_error(void) {
+    return g_last_error.c_str();
+}
+
+void mt_matrix_identity(mt_matrix* m) {
+    if (m) FromMatrix(Matrix4x4::Identity(), m);
+}
+
+void mt_matrix_multiply(mt_matrix* out, const mt_matrix* a, const mt_matrix* b) {
+    if (out && a && b) FromMatrix(ToMatrix(a) * ToMatrix(b), out);
+}
+
+void mt_matrix_translate(mt_matrix* m, double tx, double ty, double tz) {
+    Compose(m, Matrix4x4::Translate(tx, ty, tz));
+}
+
+void mt_matrix_scale(mt_matrix* m, double sx, double sy, double sz) {
+    Compose(m, Matrix4x4::ScaleNonUniform(sx, sy, sz));
+}
+
+void mt_matrix_rotate_x(mt_matrix* m, double angle_rad) {
+    Compose(m, Matrix4x4::RotateX(angle_rad));
+}
+
+void mt_matrix_rotate_y(mt_matrix* m, double angle_rad) {
+    Compose(m, Matrix4x4::RotateY(angle_rad));
+}
+
+void mt_matrix_rotate_z(mt_matrix* m, double angle_rad) {
+    Compose(m, Matrix4x4::RotateZ(angle_rad));
+}
+
+void mt_matrix_rotate_axis(mt_matrix* m, double ax, double ay, double az, double angle_rad) {
+    Compose(m, Matrix4x4::RotateAroundAxis(linear_algebra::Vector3(ax, ay, az), angle_rad));
+}
+
+void mt_matrix_shear(mt_matrix* m, double sxy, double sxz, double syx, double syz, double szx, double szy) {
+    Compose(m, Matrix4x4::Shear(sxy, sxz, syx, syz, szx, szy));
+}
+
+mt_status mt_transform_points_d(double* xyz, size_t count, size_t stride_bytes, const mt_matrix* m) {
+    return TransformPoints(xyz, count, stride_bytes, m);
+}
+
+mt_status mt_transform_points_f(float* xyz, size_t count, size_t stride_bytes, const mt_matrix* m) {
+    return TransformPoints(xyz, count, stride_bytes, m);
+}
+
+mt_status mt_transform_normals_d(double* xyz, size_t count, size_t stride_bytes, const mt_matrix* m) {
+    return TransformNormals(xyz, count, stride_bytes, m);
+}
+
+mt_status mt_transform_normals_f(float* xyz, size_t count, size_t stride_bytes, const mt_matrix* m) {
+    return TransformNormals(xyz, count, stride_bytes, m);
+}
+
+mt_mesh* mt_mesh_create(void) {
+    return new (std::nothrow) mt_mesh();
+}
+
+void mt_mesh_destroy(mt_mesh* mesh) {
+    delete mesh;
+}
+
+mt_status mt_mesh_load(mt_mesh* mesh, const char* path) {
+    if (!mesh || !path) return Fail(MT_ERROR_INVALID_ARGUMENT, "null mesh or path");
+    return Guard([&]() {
+        std::shared_ptr<file::CMeshFile> reader = file::CreateMeshFile(file::FormatFromPath(path));
+        if (!reader) return Fail(MT_ERROR_UNSUPPORTED, std::string("unsupported file extension: ") + path);
+        if (!reader->read(path)) return Fail(MT_ERROR_IO, std::string("failed to read ") + path);
+        mesh->source_ = reader;
+        mesh->mesh_ = reader->mesh();
+        return MT_OK;
+    });
+}
+
+mt_status mt_mesh_save(const mt_mesh* mesh, const char* path) {
+    if (!mesh || !path) return Fail(MT_ERROR_INVALID_ARGUMENT, "null mesh or path");
+    return Guard([&]() {
+        std::shared_ptr<file::CMeshFile> writer = file::CreateWriter(mesh->source_, file::FormatFromPath(path));
+        if (!writer) return Fail(MT_ERROR_UNSUPPORTED, std::string("unsupported file extension: ") + path);
+        if (!writer->write(path)) return Fail(MT_ERROR_IO, std::string("failed to write ") + path);
+        return MT_OK;
+    });
+}
+
+mt_status mt_mesh_set_triangles(mt_mesh* mesh, const double* xyz, size_t vertex_count,
+    const uint32_t* indices, size_t triangle_count) {
+    if (!mesh || (!xyz && vertex_count) || (!indices && triangle_count)) {
+        return Fail(MT_ERROR_INVALID_ARGUMENT, "null mesh or buffer");
+    }
+    for (size_t i = 0; i < triangle_count * 3; ++i) {
+        if (indices[i] >= vertex_count) return Fail(MT_ERROR_INVALID_ARGUMENT, "triangle index out of range");
+    }
+    return Guard([&]() {
+        auto result = std::make_shared<mesh::Mesh>();
+        result->vertices_.resize(vertex_count);
+        for (size_t i = 0; i < vertex_count; ++i) {
+            result->vertices_[i] = { xyz[i * 3], xyz[i * 3 + 1], xyz[i * 3 + 2] };
+        }
+        result->faces_.resize(triangle_count);
+        for (size_t t = 0; t < triangle_count; ++t) {
+            mesh::Face& face = result->faces_[t];
+            face.vIdx_ = { static_cast<int>(indices[t * 3]), static_cast<int>(indices[t * 3 + 1]),
+                static_cast<int>(indices[t * 3 + 2]) };
+            face.vtIdx_ = { -1, -1, -1 };
+            face.vnIdx_ = { -1, -1, -1 };
+        }
+        mesh->source_ = file::CreateMeshFile(file::MeshFormat::kObj);
+        mesh->source_->set_mesh(result);
+        mesh->mesh_ = result;
+        return MT_OK;
+    });
+}
+
+size_t mt_mesh_vertex_count(const mt_mesh* mesh) {
+    return mesh ? mesh->mesh_->vertices_.size() : 0;
+}
+
+size_t mt_mesh_triangle_count(const mt_mesh* mesh) {
+    return mesh ? mesh->mesh_->triangle_count() : 0;
+}
+
+double* mt_mesh_positions(mt_mesh* mesh) {
+    static_assert(sizeof(linear_algebra::Vector3) == 3 * sizeof(double), "Vector3 must be tightly packed");
+    if (!mesh || mesh->mesh_->vertices_.empty()) return nullptr;
+    return &mesh->mesh_->vertices_[0].x_;
+}
+
+mt_status mt_mesh_copy_triangles(const mt_mesh* mesh, uint32_t* indices, size_t capacity) {
+    if (!mesh || !indices) return Fail(MT_ERROR_INVALID_ARGUMENT, "null mesh or buffer");
+    if (capacity < mesh->mesh_->triangle_count() * 3) {
+        return Fail(MT_ERROR_INVALID_ARGUMENT, "index buffer too small");
+    }
+    // relative (negative) or dangling indices have no uint32_t form; fail before writing
+    const size_t vertex_count = mesh->mesh_->vertices_.size();
+    for (const auto& face : mesh->mesh_->faces_) {
+        if (face.vIdx_.size() < 3) continue;
+        for (int idx : face.vIdx_) {
+            if (idx < 0 || static_cast<size_t>(idx) >= vertex_count) {
+                return Fail(MT_ERROR_INVALID_ARGUMENT, "face vertex index is relative or out of range");
+            }
+        }
+    }
+    uint32_t* out = indices;
+    for (const auto& face : mesh->mesh_->faces_) {
+        const auto& idx = face.vIdx_;
+        for (size_t i = 1; i + 1 < idx.size(); ++i) {
+            *out++ = static_cast<uint32_t>(idx[0]);
+            *out++ = static_cast<uint32_t>(idx[i]);
+            *out++ = static_cast<uint32_t>(idx[i + 1]);
+        }
+    }
+    return MT_OK;
+}
+
+mt_status mt_mesh_transform(mt_mesh* mesh, const mt_matrix* m) {
+    if (!mesh || !m) return Fail(MT_ERROR_INVALID_ARGUMENT, "null mesh or matrix");
+    mesh->mesh_->apply_transform(ToMatrix(m));
+    return MT_OK;
+}
+
+mt_status mt_mesh_transform_group(mt_mesh* mesh, const char* group, const mt_matrix* m) {
+    if (!mesh || !group || !m) return Fail(MT_ERROR_INVALID_ARGUMENT, "null mesh, group or matrix");
+    return Guard([&]() {
+        const mesh::VertexSelection* selection = mesh->mesh_->select_group(group);
+        if (!selection) return Fail(MT_ERROR_INVALID_ARGUMENT, std::string("no o/g group named ") + group);
+        mesh->mesh_->apply_transform(ToMatrix(m), *selection);
+        return MT_OK;
+    });
+}
+
+mt_status mt_mesh_optimize_order(mt_mesh* mesh) {
+    if (!mesh) return Fail(MT_ERROR_INVALID_ARGUMENT, "null mesh");
+    return Guard([&]() {
+        mesh->mesh_->optimize_vertex_cache();
+        mesh->mesh_->optimize_vertex_fetch();
+        return MT_OK;
+    });
+}
+
+mt_status mt_mesh_decimate(mt_mesh* mesh, size_t target_triangles) {
+    if (!mesh) return Fail(MT_ERROR_INVALID_ARGUMENT, "null mesh");
+    return Guard([&]() {
+        mesh->mesh_->decimate(target_triangles);
+        return MT_OK;
+    });
+}
+
+}  // extern "C"
@@ -0,0 +1,109 @@
+#ifndef MESHTRANSFORM_C_H_
+#define MESHTRANSFORM_C_H_
+
+/*
+ * Stable C interface of meshtransform_core for in-process use.
+ *
+ * Functions taking caller-owned buffers work on them in place and never copy.
+ * Mesh handles own their storage; mt_mesh_positions() exposes it without a copy.
+ * Getting triangles in and out of a handle does copy: the mesh keeps per-face
+ * index lists (polygons, uv and normal indices), which a flat uint32_t index
+ * buffer cannot alias. See mt_mesh_set_triangles() and mt_mesh_copy_triangles().
+ * A shared build exports only the MT_API functions below.
+ * Every function returning mt_status leaves a message for mt_last_error() on failure.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(MESHTRANSFORM_SHARED)
+#  if defined(MESHTRANSFORM_BUILDING)
+#    define MT_API __declspec(dllexport)
+#  else
+#    define MT_API __declspec(dllimport)
+#  endif
+#elif defined(__GNUC__)
+#  define MT_API __attribute__((visibility("default")))
+#else
+#  define MT_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MT_API_VERSION 1
+
+typedef enum mt_status {
+    MT_OK = 0,
+    MT_ERROR_INVALID_ARGUMENT = 1,
+    MT_ERROR_IO = 2,
+    MT_ERROR_UNSUPPORTED = 3,
+    MT_ERROR_OUT_OF_MEMORY = 4,
+} mt_status;
+
+/* row-major 4x4 matrix, points are column vectors (p' = M * p) */
+typedef struct mt_matrix {
+    double m[16];
+} mt_matrix;
+
+typedef struct mt_mesh mt_mesh;
+
+MT_API int mt_api_version(void);
+
+/* message of the last failure on the calling thread, "" when none */
+MT_API const char* mt_last_error(void);
+
+/* ---- matrices: each op is composed after the current one (M = op * M), like the CLI ---- */
+MT_API void mt_matrix_identity(mt_matrix* m);
+MT_API void mt_matrix_multiply(mt_matrix* out, const mt_matrix* a, const mt_matrix* b);
+MT_API void mt_matrix_translate(mt_matrix* m, double tx, double ty, double tz);
+MT_API void mt_matrix_scale(mt_matrix* m, double sx, double sy, double sz);
+MT_API void mt_matrix_rotate_x(mt_matrix* m, double angle_rad);
+MT_API void mt_matrix_rotate_y(mt_matrix* m, double angle_rad);
+MT_API void mt_matrix_rotate_z(mt_matrix* m, double angle_rad);
+MT_API void mt_matrix_rotate_axis(mt_matrix* m, double ax, double ay, double az, double angle_rad);
+MT_API void mt_matrix_shear(mt_matrix* m, double sxy, double sxz, double syx, double syz, double szx, double szy);
+
+/* ---- caller-owned buffers, transformed in place ----
+ * xyz points at the first x; stride_bytes is the distance between consecutive
+ * vertices (0 means tightly packed). normals use the inverse transpose of the
+ * upper 3x3 and are renormalized. */
+MT_API mt_status mt_transform_points_d(double* xyz, size_t count, size_t stride_bytes, const mt_matrix* m);
+MT_API mt_status mt_transform_points_f(float* xyz, size_t count, size_t stride_bytes, const mt_matrix* m);
+MT_API mt_status mt_transform_normals_d(double* xyz, size_t count, size_t stride_bytes, const mt_matrix* m);
+MT_API mt_status mt_transform_normals_f(float* xyz, size_t count, size_t stride_bytes, const mt_matrix* m);
+
+/* ---- mesh handles ---- */
+MT_API mt_mesh* mt_mesh_create(void);
+MT_API void mt_mesh_destroy(mt_mesh* mesh);
+
+/* format chosen by extension: .obj, .ply, .stl, .qmesh */
+MT_API mt_status mt_mesh_load(mt_mesh* mesh, const char* path);
+MT_API mt_status mt_mesh_save(const mt_mesh* mesh, const char* path);
+
+/* replace the mesh with an indexed triangle list (3 doubles per vertex, 3 indices per triangle).
+ * both arrays are copied into the handle; the caller may free them on return */
+MT_API mt_status mt_mesh_set_triangles(mt_mesh* mesh, const double* xyz, size_t vertex_count,
+    const uint32_t* indices, size_t triangle_count);
+
+MT_API size_t mt_mesh_vertex_count(const mt_mesh* mesh);
+MT_API size_t mt_mesh_triangle_count(const mt_mesh* mesh);
+
+/* zero-copy view of the positions (vertex_count * 3 doubles); valid until the mesh is modified */
+MT_API double* mt_mesh_positions(mt_mesh* mesh);
+
+/* fan-triangulated vertex indices; capacity is in indices and must be >= 3 * triangle_count.
+ * fails without writing when a face has a relative (negative) or out of range index */
+MT_API mt_status mt_mesh_copy_triangles(const mt_mesh* mesh, uint32_t* indices, size_t capacity);
+
+MT_API mt_status mt_mesh_transform(mt_mesh* mesh, const mt_matrix* m);
+MT_API mt_status mt_mesh_transform_group(mt_mesh* mesh, const char* group, const mt_matrix* m);
+MT_API mt_status mt_mesh_optimize_order(mt_mesh* mesh);
+MT_API mt_status mt_mesh_decimate(mt_mesh* mesh, size_t target_triangles);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MESHTRANSFORM_C_H_ */
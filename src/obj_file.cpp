@@ -72,9 +72,54 @@ namespace file {
         return oss.str();
     }
 
+    struct DirectiveKeyword {
+        const char* keyword;
+        mesh::DirectiveKind kind;
+    };
+
+    const DirectiveKeyword kDirectiveKeywords[] = {
+        { "mtllib", mesh::DirectiveKind::kMtlLib },
+        { "o", mesh::DirectiveKind::kObject },
+        { "g", mesh::DirectiveKind::kGroup },
+        { "usemtl", mesh::DirectiveKind::kMaterial },
+        { "s", mesh::DirectiveKind::kSmoothing },
+    };
+
+    /*static*/ bool parseDirectiveKind(const std::string& keyword, mesh::DirectiveKind& kind) {
+        for (const auto& entry : kDirectiveKeywords) {
+            if (keyword == entry.keyword) {
+                kind = entry.kind;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*static*/ const char* directiveKeyword(mesh::DirectiveKind kind) {
+        for (const auto& entry : kDirectiveKeywords) {
+            if (entry.kind == kind) return entry.keyword;
+        }
+        return "#";
+    }
+
+    // everything after the keyword, without surrounding whitespace
+    /*static*/ std::string directiveArgument(const std::string& line, const std::string& keyword) {
+        const size_t start = line.find(keyword);
+        size_t begin = line.find_first_not_of(" \t", start + keyword.size());
+        if (begin == std::string::npos) return std::string();
+        size_t end = line.find_last_not_of(" \t\r\n");
+        return line.substr(begin, end + 1 - begin);
+    }
+
+    /*static*/ void writeDirective(std::ostream& out, const mesh::GroupTable& groups, const mesh::Directive& directive) {
+        const std::string& name = groups.name(directive.name_);
+        out << directiveKeyword(directive.kind_);
+        if (!name.empty()) out << " " << name;
+        out << "\n";
+    }
+
 
 	CObjFile::CObjFile() {
-        mesh_ = std::make_shared<mesh::Mesh>();
 	}
 
     bool CObjFile::read(const std::string& obj_file_path, mesh::Mesh& mesh) {
@@ -148,9 +193,20 @@ namespace file {
             std::cerr << "Failed to open OBJ file: " << obj_file_path << "\n";
             return false;
         }
+        if (!read(in)) return false;
+        if (mesh_->vertices_.empty()) {
+            std::cerr << "Warning: no vertices loaded from " << obj_file_path << "\n";
+        }
+        return true;
+	}
+
+	bool CObjFile::read(std::istream& in) {
         mesh_->vertices_.clear();
+        mesh_->groups_.clear();
+        mesh_->invalidate_selections();
         other_info_str_list_.clear();
         std::string line;
+        mesh::DirectiveKind directive_kind;
         while (std::getline(in, line)) {
             std::istringstream iss(line);
             std::string type;
@@ -183,16 +239,16 @@ namespace file {
 				}
 				mesh_->faces_.push_back(face);
             }
+            else if (parseDirectiveKind(type, directive_kind)) {
+                mesh_->groups_.add(directive_kind, directiveArgument(line, type),
+                    static_cast<uint32_t>(mesh_->faces_.size()));
+            }
             else {
                 other_info_str_list_.push_back(line);
             }
         }
 
-        if (mesh_->vertices_.empty()) {
-            std::cerr << "Warning: no vertices loaded from " << obj_file_path << "\n";
-        }
-
-        return true;
+        return !in.bad();
 	}
 
 	bool CObjFile::write(const std::string& obj_file_path) const {
@@ -201,6 +257,14 @@ namespace file {
             std::cerr << "Failed to write OBJ file: " << obj_file_path << "\n";
             return false;
         }
+        return write(out);
+	}
+
+	bool CObjFile::write(std::ostream& out) const {
+        const mesh::GroupTable& groups = mesh_->groups_;
+        for (const auto& directive : groups.directives()) {
+            if (directive.kind_ == mesh::DirectiveKind::kMtlLib) writeDirective(out, groups, directive);
+        }
 
         for (const auto& v : mesh_->vertices_) {
             out << "v " << v.x_ << " " << v.y_ << " " << v.z_ << "\n";
@@ -211,21 +275,27 @@ namespace file {
         for (const auto& vn : mesh_->normals_) {
             out << "vn " << vn.x_ << " " << vn.y_ << " " << vn.z_ << "\n";
         }
-        for (const auto& face : mesh_->faces_) {
+        // o / g / usemtl / s go back in front of the face they preceded
+        auto directive = groups.directives().begin();
+        const auto directive_end = groups.directives().end();
+        auto flushDirectives = [&](size_t face_index) {
+            for (; directive != directive_end && directive->face_ <= face_index; ++directive) {
+                if (directive->kind_ != mesh::DirectiveKind::kMtlLib) writeDirective(out, groups, *directive);
+            }
+        };
+        for (size_t f = 0; f < mesh_->faces_.size(); ++f) {
+            flushDirectives(f);
+            const auto& face = mesh_->faces_[f];
             out << "f";
             for (size_t i = 0; i < face.vIdx_.size(); ++i) {
                 out<<" "<< makeOBJIndex({face.vIdx_[i], face.vtIdx_[i], face.vnIdx_[i]});
             }
             out << "\n";
         }
+        flushDirectives(static_cast<size_t>(-1));
         for (const auto& str : other_info_str_list_) {
             out << str << "\n";
         }
-        return true;
+        return static_cast<bool>(out);
 	}
-
-    std::shared_ptr<mesh::Mesh> CObjFile::mesh()
-    {
-        return mesh_;
-    }
 }
\ No newline at end of file
@@ -5,12 +5,14 @@
 #include <vector>
 #include <memory>
 
+#include "mesh_file.h"
+
 namespace mesh {
 	class Mesh;
 }
 
 namespace file {
-	class CObjFile {
+	class CObjFile : public CMeshFileBase<CObjFile, MeshFormat::kObj> {
 	public:
 		explicit CObjFile();
 
@@ -20,16 +22,15 @@ namespace file {
 		static bool saveOBJ(const std::string& file_path, const mesh::Mesh& mesh);
 
 		// Ӽ OBJ ļȡ ( "v x y z")
-		bool read(const std::string& obj_file_path);
+		bool read(const std::string& obj_file_path) override;
 
 		// Ϊ OBJ ļ
-		bool write(const std::string& obj_file_path) const;
-
-		std::shared_ptr<mesh::Mesh> mesh();
+		bool write(const std::string& obj_file_path) const override;
+		bool read(std::istream& in) override;
+		bool write(std::ostream& out) const override;
 
 	private:
 		std::vector<std::string> other_info_str_list_;
-		std::shared_ptr<mesh::Mesh> mesh_ = nullptr;
 	};
 }
 
@@ -0,0 +1,586 @@
+#include "ply_file.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+#include "file_buffer.h"
+#include "mesh/mesh.h"
+
+namespace file {
+    namespace {
+        static_assert(sizeof(linear_algebra::Vector3) == 3 * sizeof(double),
+            "Vector3 must be tightly packed for bulk copies");
+
+        enum class PlyType { kInvalid, kInt8, kUInt8, kInt16, kUInt16, kInt32, kUInt32, kFloat32, kFloat64 };
+
+        PlyType ParsePlyType(const std::string& name) {
+            if (name == "char" || name == "int8") return PlyType::kInt8;
+            if (name == "uchar" || name == "uint8") return PlyType::kUInt8;
+            if (name == "short" || name == "int16") return PlyType::kInt16;
+            if (name == "ushort" || name == "uint16") return PlyType::kUInt16;
+            if (name == "int" || name == "int32") return PlyType::kInt32;
+            if (name == "uint" || name == "uint32") return PlyType::kUInt32;
+            if (name == "float" || name == "float32") return PlyType::kFloat32;
+            if (name == "double" || name == "float64") return PlyType::kFloat64;
+            return PlyType::kInvalid;
+        }
+
+        size_t PlyTypeSize(PlyType type) {
+            switch (type) {
+            case PlyType::kInt8: case PlyType::kUInt8: return 1;
+            case PlyType::kInt16: case PlyType::kUInt16: return 2;
+            case PlyType::kInt32: case PlyType::kUInt32: case PlyType::kFloat32: return 4;
+            case PlyType::kFloat64: return 8;
+            default: return 0;
+            }
+        }
+
+        template <typename T>
+        T Load(const char* p) {
+            T value;
+            std::memcpy(&value, p, sizeof(T));
+            return value;
+        }
+
+        double LoadScalar(const char* p, PlyType type) {
+            switch (type) {
+            case PlyType::kInt8: return Load<int8_t>(p);
+            case PlyType::kUInt8: return Load<uint8_t>(p);
+            case PlyType::kInt16: return Load<int16_t>(p);
+            case PlyType::kUInt16: return Load<uint16_t>(p);
+            case PlyType::kInt32: return Load<int32_t>(p);
+            case PlyType::kUInt32: return Load<uint32_t>(p);
+            case PlyType::kFloat32: return Load<float>(p);
+            case PlyType::kFloat64: return Load<double>(p);
+            default: return 0.0;
+            }
+        }
+
+        int64_t LoadInteger(const char* p, PlyType type) {
+            switch (type) {
+            case PlyType::kInt8: return Load<int8_t>(p);
+            case PlyType::kUInt8: return Load<uint8_t>(p);
+            case PlyType::kInt16: return Load<int16_t>(p);
+            case PlyType::kUInt16: return Load<uint16_t>(p);
+            case PlyType::kInt32: return Load<int32_t>(p);
+            case PlyType::kUInt32: return Load<uint32_t>(p);
+            default: return static_cast<int64_t>(LoadScalar(p, type));
+            }
+        }
+
+        struct PlyProperty {
+            std::string name_;
+            PlyType type_ = PlyType::kInvalid;
+            bool is_list_ = false;
+            PlyType count_type_ = PlyType::kInvalid;
+        };
+
+        struct PlyElement {
+            std::string name_;
+            size_t count_ = 0;
+            std::vector<PlyProperty> properties_;
+
+            // byte size of one item, 0 when it contains a list
+            size_t fixed_stride() const {
+                size_t stride = 0;
+                for (const auto& prop : properties_) {
+                    if (prop.is_list_) return 0;
+                    stride += PlyTypeSize(prop.type_);
+                }
+                return stride;
+            }
+        };
+
+        bool IsVertexIndexList(const PlyProperty& prop) {
+            return prop.is_list_ && (prop.name_ == "vertex_indices" || prop.name_ == "vertex_index");
+        }
+
+        // smallest byte size one item can have: empty lists, except that a face lists at least
+        // three vertices. bounds element counts against the file before anything is sized
+        size_t MinItemSize(const PlyElement& element) {
+            size_t size = 0;
+            for (const auto& prop : element.properties_) {
+                if (!prop.is_list_) {
+                    size += PlyTypeSize(prop.type_);
+                    continue;
+                }
+                size += PlyTypeSize(prop.count_type_);
+                if (element.name_ == "face" && IsVertexIndexList(prop)) size += 3 * PlyTypeSize(prop.type_);
+            }
+            return size;
+        }
+
+        // walk one property of an item; returns the pointer past it, nullptr on overrun
+        const char* SkipProperty(const PlyProperty& prop, const char* p, const char* end) {
+            if (!prop.is_list_) {
+                const size_t size = PlyTypeSize(prop.type_);
+                return static_cast<size_t>(end - p) >= size ? p + size : nullptr;
+            }
+            const size_t count_size = PlyTypeSize(prop.count_type_);
+            if (static_cast<size_t>(end - p) < count_size) return nullptr;
+            const int64_t count = LoadInteger(p, prop.count_type_);
+            p += count_size;
+            if (count < 0 || static_cast<uint64_t>(count) > static_cast<size_t>(end - p) / PlyTypeSize(prop.type_)) {
+                return nullptr;
+            }
+            return p + static_cast<size_t>(count) * PlyTypeSize(prop.type_);
+        }
+
+        // walk one item of an element; returns the pointer past it, nullptr on overrun
+        const char* SkipItem(const PlyElement& element, const char* p, const char* end) {
+            for (const auto& prop : element.properties_) {
+                if (!(p = SkipProperty(prop, p, end))) return nullptr;
+            }
+            return p;
+        }
+
+        bool ParseHeader(const char* data, size_t size, std::vector<PlyElement>& elements, size_t& body_offset) {
+            static const char kEndHeader[] = "end_header";
+            const char* end = data + size;
+            const char* p = data;
+            bool binary_le = false;
+            bool first = true;
+            while (p < end) {
+                const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+                if (!eol) return false;
+                std::istringstream line(std::string(p, eol));
+                p = eol + 1;
+
+                std::string keyword;
+                line >> keyword;
+                if (first) {
+                    if (keyword != "ply") return false;
+                    first = false;
+                }
+                else if (keyword == "format") {
+                    std::string format;
+                    line >> format;
+                    binary_le = format == "binary_little_endian";
+                }
+                else if (keyword == "element") {
+                    PlyElement element;
+                    line >> element.name_ >> element.count_;
+                    elements.push_back(element);
+                }
+                else if (keyword == "property") {
+                    if (elements.empty()) return false;
+                    PlyProperty prop;
+                    std::string type;
+                    line >> type;
+                    if (type == "list") {
+                        std::string count_type, item_type;
+                        line >> count_type >> item_type;
+                        prop.is_list_ = true;
+                        prop.count_type_ = ParsePlyType(count_type);
+                        prop.type_ = ParsePlyType(item_type);
+                        if (prop.count_type_ == PlyType::kInvalid) return false;
+                    }
+                    else {
+                        prop.type_ = ParsePlyType(type);
+                    }
+                    if (prop.type_ == PlyType::kInvalid) return false;
+                    line >> prop.name_;
+                    elements.back().properties_.push_back(prop);
+                }
+                else if (keyword == kEndHeader) {
+                    body_offset = p - data;
+                    if (!binary_le) {
+                        std::cerr << "Only binary_little_endian PLY is supported\n";
+                        return false;
+                    }
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // which vertex property feeds which mesh attribute component
+        enum VertexSlot { kX, kY, kZ, kNX, kNY, kNZ, kU, kV, kSlotCount, kIgnore = kSlotCount };
+
+        VertexSlot SlotFromName(const std::string& name) {
+            if (name == "x") return kX;
+            if (name == "y") return kY;
+            if (name == "z") return kZ;
+            if (name == "nx") return kNX;
+            if (name == "ny") return kNY;
+            if (name == "nz") return kNZ;
+            if (name == "s" || name == "u" || name == "texture_u" || name == "texture_s") return kU;
+            if (name == "t" || name == "v" || name == "texture_v" || name == "texture_t") return kV;
+            return kIgnore;
+        }
+
+        const char* ReadVertices(const PlyElement& element, const char* p, const char* end, mesh::Mesh& mesh) {
+            const size_t stride = element.fixed_stride();
+            if (stride == 0 || element.count_ > static_cast<size_t>(end - p) / stride) return nullptr;
+
+            std::vector<VertexSlot> slots;
+            std::vector<size_t> offsets;
+            bool has_slot[kSlotCount] = {};
+            size_t offset = 0;
+            for (const auto& prop : element.properties_) {
+                slots.push_back(SlotFromName(prop.name_));
+                offsets.push_back(offset);
+                offset += PlyTypeSize(prop.type_);
+                if (slots.back() != kIgnore) has_slot[slots.back()] = true;
+            }
+
+            mesh.vertices_.resize(element.count_);
+            const bool positions_only = element.properties_.size() == 3 &&
+                slots[0] == kX && slots[1] == kY && slots[2] == kZ &&
+                element.properties_[0].type_ == PlyType::kFloat64 &&
+                element.properties_[1].type_ == PlyType::kFloat64 &&
+                element.properties_[2].type_ == PlyType::kFloat64;
+            if (positions_only) {
+                std::memcpy(mesh.vertices_.data(), p, stride * element.count_);
+                return p + stride * element.count_;
+            }
+
+            const bool has_normals = has_slot[kNX] || has_slot[kNY] || has_slot[kNZ];
+            const bool has_texcoords = has_slot[kU] || has_slot[kV];
+            if (has_normals) mesh.normals_.resize(element.count_);
+            if (has_texcoords) mesh.texcoords_.resize(element.count_);
+
+            for (size_t i = 0; i < element.count_; ++i, p += stride) {
+                double values[kSlotCount + 1] = {};
+                for (size_t k = 0; k < slots.size(); ++k) {
+                    values[slots[k]] = LoadScalar(p + offsets[k], element.properties_[k].type_);
+                }
+                mesh.vertices_[i] = { values[kX], values[kY], values[kZ] };
+                if (has_normals) mesh.normals_[i] = { values[kNX], values[kNY], values[kNZ] };
+                if (has_texcoords) mesh.texcoords_[i] = { values[kU], values[kV] };
+            }
+            return p;
+        }
+
+        // nullptr on overrun, or with error set when a face references a missing vertex
+        const char* ReadFaces(const PlyElement& element, const char* p, const char* end, mesh::Mesh& mesh,
+            std::string& error) {
+            int list_index = -1;
+            for (size_t k = 0; k < element.properties_.size(); ++k) {
+                const auto& prop = element.properties_[k];
+                if (IsVertexIndexList(prop)) list_index = static_cast<int>(k);
+            }
+            if (list_index < 0) {
+                for (size_t i = 0; i < element.count_ && p; ++i) p = SkipItem(element, p, end);
+                return p;
+            }
+
+            // byte size of every other scalar property, 0 for lists that need a walk
+            std::vector<size_t> skip_size(element.properties_.size(), 0);
+            for (size_t k = 0; k < element.properties_.size(); ++k) {
+                if (!element.properties_[k].is_list_) skip_size[k] = PlyTypeSize(element.properties_[k].type_);
+            }
+
+            const size_t vertex_count = mesh.vertices_.size();
+            const bool has_vt = !mesh.texcoords_.empty();
+            const bool has_vn = !mesh.normals_.empty();
+            mesh.faces_.reserve(mesh.faces_.size() + element.count_);
+            for (size_t i = 0; i < element.count_; ++i) {
+                mesh::Face face;
+                for (size_t k = 0; k < element.properties_.size(); ++k) {
+                    const auto& prop = element.properties_[k];
+                    if (static_cast<int>(k) != list_index) {
+                        if (skip_size[k] == 0) {
+                            p = SkipProperty(prop, p, end);
+                            if (!p) return nullptr;
+                        }
+                        else {
+                            if (static_cast<size_t>(end - p) < skip_size[k]) return nullptr;
+                            p += skip_size[k];
+                        }
+                        continue;
+                    }
+                    const size_t count_size = PlyTypeSize(prop.count_type_);
+                    const size_t index_size = PlyTypeSize(prop.type_);
+                    if (static_cast<size_t>(end - p) < count_size) return nullptr;
+                    const int64_t count_value = LoadInteger(p, prop.count_type_);
+                    p += count_size;
+                    if (count_value < 0 || static_cast<uint64_t>(count_value) > static_cast<size_t>(end - p) / index_size) {
+                        return nullptr;
+                    }
+                    const size_t count = static_cast<size_t>(count_value);
+                    face.vIdx_.resize(count);
+                    if (prop.type_ == PlyType::kInt32 || prop.type_ == PlyType::kUInt32) {
+                        std::memcpy(face.vIdx_.data(), p, count * sizeof(int));
+                    }
+                    else {
+                        for (size_t c = 0; c < count; ++c) {
+                            face.vIdx_[c] = static_cast<int>(LoadInteger(p + c * index_size, prop.type_));
+                        }
+                    }
+                    p += count * index_size;
+                    for (int v : face.vIdx_) {
+                        if (!mesh::IsValidIndex(v, vertex_count)) {
+                            error = "face " + std::to_string(i) + " references vertex " + std::to_string(v) +
+                                " of " + std::to_string(vertex_count);
+                            return nullptr;
+                        }
+                    }
+                }
+                face.vtIdx_ = has_vt ? face.vIdx_ : std::vector<int>(face.vIdx_.size(), -1);
+                face.vnIdx_ = has_vn ? face.vIdx_ : std::vector<int>(face.vIdx_.size(), -1);
+                mesh.faces_.push_back(std::move(face));
+            }
+            return p;
+        }
+
+        struct CornerKey {
+            int v, vt, vn;
+            bool operator==(const CornerKey& rhs) const { return v == rhs.v && vt == rhs.vt && vn == rhs.vn; }
+        };
+
+        struct CornerKeyHash {
+            size_t operator()(const CornerKey& key) const {
+                uint64_t h = static_cast<uint32_t>(key.v);
+                h = h * 0x9E3779B97F4A7C15ull ^ static_cast<uint32_t>(key.vt);
+                h = h * 0x9E3779B97F4A7C15ull ^ static_cast<uint32_t>(key.vn);
+                return static_cast<size_t>(h ^ (h >> 29));
+            }
+        };
+
+        // PLY stores one attribute set per vertex. when every position already has a
+        // single texcoord/normal the vertices are written as is; otherwise each distinct
+        // (v, vt, vn) corner becomes its own output vertex.
+        struct VertexLayout {
+            bool has_vt_ = false;
+            bool has_vn_ = false;
+            bool split_ = false;
+            std::vector<CornerKey> vertices_;       // output vertex -> source indices (split only)
+            std::vector<std::vector<int>> faces_;  // output face indices (split only)
+            std::vector<int> vt_of_;               // position -> texcoord (no split)
+            std::vector<int> vn_of_;               // position -> normal (no split)
+        };
+
+        bool AllCornersValid(const mesh::Mesh& mesh, const std::vector<const mesh::Face*>& faces, bool texcoords) {
+            const size_t count = texcoords ? mesh.texcoords_.size() : mesh.normals_.size();
+            if (count == 0) return false;
+            for (const mesh::Face* face : faces) {
+                const std::vector<int>& indices = texcoords ? face->vtIdx_ : face->vnIdx_;
+                if (indices.size() != face->vIdx_.size()) return false;
+                for (int idx : indices) {
+                    if (!mesh::IsValidIndex(idx, count)) return false;
+                }
+            }
+            return true;
+        }
+
+        // faces holds only faces whose position indices are all valid
+        VertexLayout BuildVertexLayout(const mesh::Mesh& mesh, const std::vector<const mesh::Face*>& faces) {
+            VertexLayout layout;
+            layout.has_vt_ = AllCornersValid(mesh, faces, true);
+            layout.has_vn_ = AllCornersValid(mesh, faces, false);
+            if (!layout.has_vt_ && !layout.has_vn_) return layout;
+
+            layout.vt_of_.assign(mesh.vertices_.size(), -1);
+            layout.vn_of_.assign(mesh.vertices_.size(), -1);
+            for (const mesh::Face* f : faces) {
+                const mesh::Face& face = *f;
+                for (size_t i = 0; i < face.vIdx_.size() && !layout.split_; ++i) {
+                    const int v = face.vIdx_[i];
+                    if (layout.has_vt_) {
+                        int& vt = layout.vt_of_[v];
+                        if (vt >= 0 && vt != face.vtIdx_[i]) layout.split_ = true;
+                        vt = face.vtIdx_[i];
+                    }
+                    if (layout.has_vn_) {
+                        int& vn = layout.vn_of_[v];
+                        if (vn >= 0 && vn != face.vnIdx_[i]) layout.split_ = true;
+                        vn = face.vnIdx_[i];
+                    }
+                }
+            }
+            if (!layout.split_) return layout;
+
+            layout.vt_of_.clear();
+            layout.vn_of_.clear();
+            std::unordered_map<CornerKey, int, CornerKeyHash> unique;
+            unique.reserve(mesh.vertices_.size());
+            layout.faces_.reserve(faces.size());
+            for (const mesh::Face* f : faces) {
+                const mesh::Face& face = *f;
+                std::vector<int> indices(face.vIdx_.size());
+                for (size_t i = 0; i < face.vIdx_.size(); ++i) {
+                    const CornerKey key{ face.vIdx_[i],
+                        layout.has_vt_ ? face.vtIdx_[i] : -1,
+                        layout.has_vn_ ? face.vnIdx_[i] : -1 };
+                    auto it = unique.emplace(key, static_cast<int>(layout.vertices_.size())).first;
+                    if (it->second == static_cast<int>(layout.vertices_.size())) layout.vertices_.push_back(key);
+                    indices[i] = it->second;
+                }
+                layout.faces_.push_back(std::move(indices));
+            }
+            return layout;
+        }
+
+        template <typename T>
+        char* Store(char* p, T value) {
+            std::memcpy(p, &value, sizeof(T));
+            return p + sizeof(T);
+        }
+    }  // namespace
+
+    CPlyFile::CPlyFile() {
+    }
+
+    bool CPlyFile::read(const std::string& ply_file_path) {
+        CFileBuffer buffer;
+        if (!buffer.open(ply_file_path)) {
+            std::cerr << "Failed to open PLY file: " << ply_file_path << "\n";
+            return false;
+        }
+        return parse(buffer, ply_file_path);
+    }
+
+    bool CPlyFile::read(std::istream& in) {
+        CFileBuffer buffer;
+        if (!buffer.open(in)) {
+            std::cerr << "Failed to read PLY stream\n";
+            return false;
+        }
+        return parse(buffer, "<stream>");
+    }
+
+    bool CPlyFile::parse(const CFileBuffer& buffer, const std::string& ply_file_path) {
+        if (!IsLittleEndianHost()) {
+            std::cerr << "PLY I/O requires a little endian host\n";
+            return false;
+        }
+
+        std::vector<PlyElement> elements;
+        size_t body_offset = 0;
+        if (!ParseHeader(buffer.data(), buffer.size(), elements, body_offset)) {
+            std::cerr << "Invalid PLY header: " << ply_file_path << "\n";
+            return false;
+        }
+
+        *mesh_ = mesh::Mesh();
+        const char* p = buffer.data() + body_offset;
+        const char* end = buffer.data() + buffer.size();
+        for (const auto& element : elements) {
+            // a header count the remaining bytes cannot hold is rejected before any
+            // resize/reserve or size arithmetic uses it
+            if (element.properties_.empty()) continue;
+            if (element.count_ > static_cast<size_t>(end - p) / MinItemSize(element)) {
+                std::cerr << "Invalid PLY element '" << element.name_ << "': " << element.count_
+                    << " items do not fit in the file: " << ply_file_path << "\n";
+                return false;
+            }
+            if (element.name_ == "vertex") {
+                p = ReadVertices(element, p, end, *mesh_);
+            }
+            else if (element.name_ == "face") {
+                std::string error;
+                p = ReadFaces(element, p, end, *mesh_, error);
+                if (!error.empty()) {
+                    std::cerr << "Invalid PLY " << error << ": " << ply_file_path << "\n";
+                    return false;
+                }
+            }
+            else if (const size_t stride = element.fixed_stride()) {
+                p = element.count_ <= static_cast<size_t>(end - p) / stride ? p + stride * element.count_ : nullptr;
+            }
+            else {
+                for (size_t i = 0; i < element.count_ && p; ++i) p = SkipItem(element, p, end);
+            }
+            if (!p) {
+                std::cerr << "Truncated PLY element '" << element.name_ << "': " << ply_file_path << "\n";
+                return false;
+            }
+        }
+
+        if (mesh_->vertices_.empty()) {
+            std::cerr << "Warning: no vertices loaded from " << ply_file_path << "\n";
+        }
+        return true;
+    }
+
+    bool CPlyFile::write(const std::string& ply_file_path) const {
+        std::ofstream out(ply_file_path, std::ios::binary);
+        if (!out.is_open()) {
+            std::cerr << "Failed to write PLY file: " << ply_file_path << "\n";
+            return false;
+        }
+        return write(out);
+    }
+
+    bool CPlyFile::write(std::ostream& out) const {
+        if (!IsLittleEndianHost()) {
+            std::cerr << "PLY I/O requires a little endian host\n";
+            return false;
+        }
+
+        const mesh::Mesh& mesh = *mesh_;
+        const std::vector<const mesh::Face*> faces = WritableFaces(mesh, "PLY");
+        const VertexLayout layout = BuildVertexLayout(mesh, faces);
+        const size_t vertex_count = layout.split_ ? layout.vertices_.size() : mesh.vertices_.size();
+
+        size_t max_face_size = 0;
+        for (const mesh::Face* face : faces) max_face_size = std::max(max_face_size, face->vIdx_.size());
+        const bool wide_count = max_face_size > 255;
+
+        std::ostringstream header;
+        header << "ply\n"
+            << "format binary_little_endian 1.0\n"
+            << "comment MeshTransform\n"
+            << "element vertex " << vertex_count << "\n"
+            << "property double x\nproperty double y\nproperty double z\n";
+        if (layout.has_vn_) header << "property double nx\nproperty double ny\nproperty double nz\n";
+        if (layout.has_vt_) header << "property double s\nproperty double t\n";
+        header << "element face " << faces.size() << "\n"
+            << "property list " << (wide_count ? "int" : "uchar") << " int vertex_indices\n"
+            << "end_header\n";
+        const std::string header_str = header.str();
+        out.write(header_str.data(), header_str.size());
+
+        if (!layout.has_vt_ && !layout.has_vn_) {
+            // positions only: the vertex block is the in-memory array
+            out.write(reinterpret_cast<const char*>(mesh.vertices_.data()),
+                mesh.vertices_.size() * sizeof(linear_algebra::Vector3));
+        }
+        else {
+            const size_t stride = sizeof(double) * (3 + (layout.has_vn_ ? 3 : 0) + (layout.has_vt_ ? 2 : 0));
+            std::vector<char> block(stride * vertex_count);
+            char* p = block.data();
+            for (size_t i = 0; i < vertex_count; ++i) {
+                const int v = layout.split_ ? layout.vertices_[i].v : static_cast<int>(i);
+                const int vt = layout.split_ ? layout.vertices_[i].vt : layout.vt_of_[i];
+                const int vn = layout.split_ ? layout.vertices_[i].vn : layout.vn_of_[i];
+                std::memcpy(p, &mesh.vertices_[v], sizeof(linear_algebra::Vector3));
+                p += sizeof(linear_algebra::Vector3);
+                if (layout.has_vn_) {
+                    const linear_algebra::Vector3 n = vn >= 0 ? mesh.normals_[vn] : linear_algebra::Vector3();
+                    std::memcpy(p, &n, sizeof(n));
+                    p += sizeof(n);
+                }
+                if (layout.has_vt_) {
+                    const linear_algebra::Vector2 uv = vt >= 0 ? mesh.texcoords_[vt] : linear_algebra::Vector2();
+                    p = Store(p, uv.u_);
+                    p = Store(p, uv.v_);
+                }
+            }
+            out.write(block.data(), block.size());
+        }
+
+        size_t face_bytes = 0;
+        for (const mesh::Face* face : faces) {
+            face_bytes += (wide_count ? 4 : 1) + face->vIdx_.size() * sizeof(int);
+        }
+        std::vector<char> block(face_bytes);
+        char* p = block.data();
+        for (size_t f = 0; f < faces.size(); ++f) {
+            const std::vector<int>& indices = layout.split_ ? layout.faces_[f] : faces[f]->vIdx_;
+            if (wide_count) p = Store(p, static_cast<int32_t>(indices.size()));
+            else p = Store(p, static_cast<uint8_t>(indices.size()));
+            std::memcpy(p, indices.data(), indices.size() * sizeof(int));
+            p += indices.size() * sizeof(int);
+        }
+        out.write(block.data(), block.size());
+        return static_cast<bool>(out);
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef PLY_FILE_H_
+#define PLY_FILE_H_
+
+#include <string>
+
+#include "mesh_file.h"
+
+namespace file {
+	// binary little endian PLY. vertex properties x/y/z, nx/ny/nz and s/t (or u/v)
+	// map to vertices_, normals_ and texcoords_; the face list to faces_.
+	// other elements and properties are skipped on read.
+	class CPlyFile : public CMeshFileBase<CPlyFile, MeshFormat::kPly> {
+	public:
+		explicit CPlyFile();
+
+		bool read(const std::string& ply_file_path) override;
+		bool read(std::istream& in) override;
+
+		// per-corner attributes that do not map 1:1 onto positions split the vertex
+		bool write(const std::string& ply_file_path) const override;
+		bool write(std::ostream& out) const override;
+
+	private:
+		bool parse(const CFileBuffer& buffer, const std::string& ply_file_path);
+	};
+}
+
+#endif // PLY_FILE_H_
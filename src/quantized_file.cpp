@@ -0,0 +1,574 @@
+#include "quantized_file.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "file_buffer.h"
+#include "mesh/mesh.h"
+
+namespace file {
+    namespace {
+        constexpr char kMagic[4] = { 'M', 'T', 'Q', 'M' };
+        // version 2 adds the kDirectives chunk; meshes without directives are still
+        // written as version 1 so older readers keep loading them
+        constexpr uint32_t kVersion = 2;
+        constexpr uint32_t kVersionNoDirectives = 1;
+        constexpr size_t kChunkElements = size_t(1) << 16;
+
+        enum ChunkType : uint32_t { kPositions = 0, kTexcoords = 1, kNormals = 2, kFaces = 3, kDirectives = 4 };
+
+        // a directive is at least a face delta, a kind and a name length byte
+        constexpr uint64_t kMinDirectiveBytes = 3;
+
+        struct ContainerHeader {
+            char magic_[4];
+            uint32_t version_;
+            uint32_t position_bits_;
+            uint32_t texcoord_bits_;
+            uint32_t normal_bits_;
+            uint32_t chunk_count_;
+            double box_min_[3];
+            double box_max_[3];
+            double uv_min_[2];
+            double uv_max_[2];
+            uint64_t vertex_count_;
+            uint64_t texcoord_count_;
+            uint64_t normal_count_;
+            uint64_t face_count_;
+        };
+        static_assert(sizeof(ContainerHeader) == 136, "container header must not be padded");
+
+        struct ChunkEntry {
+            uint32_t type_;
+            uint32_t reserved_;
+            uint64_t first_;   // first element (vertex, texcoord, normal or face) of the chunk
+            uint64_t count_;
+            uint64_t offset_;  // from the start of the file
+            uint64_t size_;
+        };
+        static_assert(sizeof(ChunkEntry) == 40, "chunk entry must not be padded");
+
+        class ByteWriter {
+        public:
+            void varint(uint64_t value) {
+                while (value >= 0x80) {
+                    bytes_.push_back(static_cast<uint8_t>(value | 0x80));
+                    value >>= 7;
+                }
+                bytes_.push_back(static_cast<uint8_t>(value));
+            }
+
+            void zigzag(int64_t value) {
+                varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+            }
+
+            void string(const std::string& value) {
+                varint(value.size());
+                bytes_.insert(bytes_.end(), value.begin(), value.end());
+            }
+
+            std::vector<uint8_t>& bytes() { return bytes_; }
+
+        private:
+            std::vector<uint8_t> bytes_;
+        };
+
+        class ByteReader {
+        public:
+            ByteReader(const uint8_t* begin, const uint8_t* end) : p_(begin), end_(end) {}
+
+            uint64_t varint() {
+                uint64_t value = 0;
+                for (int shift = 0; shift < 64; shift += 7) {
+                    if (p_ >= end_) {
+                        ok_ = false;
+                        return 0;
+                    }
+                    const uint8_t byte = *p_++;
+                    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                    if (!(byte & 0x80)) return value;
+                }
+                ok_ = false;
+                return value;
+            }
+
+            int64_t zigzag() {
+                const uint64_t value = varint();
+                return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+            }
+
+            bool string(std::string& value) {
+                const uint64_t size = varint();
+                if (!ok_ || size > static_cast<uint64_t>(end_ - p_)) {
+                    ok_ = false;
+                    return false;
+                }
+                value.assign(reinterpret_cast<const char*>(p_), static_cast<size_t>(size));
+                p_ += size;
+                return true;
+            }
+
+            bool ok() const { return ok_; }
+
+        private:
+            const uint8_t* p_;
+            const uint8_t* end_;
+            bool ok_ = true;
+        };
+
+        // maps [min, max] onto the integers [0, 2^bits - 1]
+        struct Quantizer {
+            Quantizer(double min, double max, int bits)
+                : min_(min), levels_(static_cast<double>((uint64_t(1) << bits) - 1)) {
+                const double extent = max - min;
+                scale_ = extent > 0 ? levels_ / extent : 0.0;
+                inverse_ = extent > 0 ? extent / levels_ : 0.0;
+            }
+
+            int64_t encode(double x) const {
+                const double q = std::round((x - min_) * scale_);
+                return static_cast<int64_t>(std::min(std::max(q, 0.0), levels_));
+            }
+
+            double decode(int64_t q) const { return min_ + q * inverse_; }
+
+            double min_, levels_, scale_, inverse_;
+        };
+
+        // octahedral normal encoding (Cigolle et al. 2014), signed fixed point per component
+        void EncodeOctahedral(const linear_algebra::Vector3& n, int bits, int64_t out[2]) {
+            const double sum = std::abs(n.x_) + std::abs(n.y_) + std::abs(n.z_);
+            double x = sum > 0 ? n.x_ / sum : 0.0;
+            double y = sum > 0 ? n.y_ / sum : 0.0;
+            if (sum > 0 && n.z_ < 0) {
+                const double fx = (1.0 - std::abs(y)) * (x >= 0 ? 1.0 : -1.0);
+                const double fy = (1.0 - std::abs(x)) * (y >= 0 ? 1.0 : -1.0);
+                x = fx;
+                y = fy;
+            }
+            const double max_value = static_cast<double>((int64_t(1) << (bits - 1)) - 1);
+            out[0] = static_cast<int64_t>(std::round(std::min(std::max(x, -1.0), 1.0) * max_value));
+            out[1] = static_cast<int64_t>(std::round(std::min(std::max(y, -1.0), 1.0) * max_value));
+        }
+
+        linear_algebra::Vector3 DecodeOctahedral(const int64_t in[2], int bits) {
+            const double max_value = static_cast<double>((int64_t(1) << (bits - 1)) - 1);
+            double x = in[0] / max_value;
+            double y = in[1] / max_value;
+            const double z = 1.0 - std::abs(x) - std::abs(y);
+            if (z < 0) {
+                const double fx = (1.0 - std::abs(y)) * (x >= 0 ? 1.0 : -1.0);
+                const double fy = (1.0 - std::abs(x)) * (y >= 0 ? 1.0 : -1.0);
+                x = fx;
+                y = fy;
+            }
+            return linear_algebra::Vector3(x, y, z).normalized();
+        }
+
+        template <typename Fn>
+        void ParallelFor(size_t count, Fn&& fn) {
+            const size_t workers = std::min<size_t>(count, std::max(1u, std::thread::hardware_concurrency()));
+            if (workers <= 1) {
+                for (size_t i = 0; i < count; ++i) fn(i);
+                return;
+            }
+            std::atomic<size_t> next(0);
+            std::vector<std::thread> threads;
+            threads.reserve(workers);
+            for (size_t w = 0; w < workers; ++w) {
+                threads.emplace_back([&]() {
+                    for (size_t i = next++; i < count; i = next++) fn(i);
+                });
+            }
+            for (auto& thread : threads) thread.join();
+        }
+
+        void AddChunks(std::vector<ChunkEntry>& chunks, ChunkType type, size_t element_count) {
+            for (size_t first = 0; first < element_count; first += kChunkElements) {
+                ChunkEntry entry{};
+                entry.type_ = type;
+                entry.first_ = first;
+                entry.count_ = std::min(kChunkElements, element_count - first);
+                chunks.push_back(entry);
+            }
+        }
+
+        // Every element costs at least one varint byte per component (a face at least its
+        // corner count), so larger header counts cannot come from this file. Each stream's
+        // chunks must tile [0, count) exactly: a gap would decode as zeros and an overlap
+        // would have two decode threads write the same elements. The optional directive
+        // chunk (version 2) stands alone and covers the whole directive list.
+        bool ValidChunkTable(const ContainerHeader& header, const std::vector<ChunkEntry>& chunks, size_t file_size) {
+            const uint64_t counts[4] = { header.vertex_count_, header.texcoord_count_, header.normal_count_, header.face_count_ };
+            const uint64_t min_bytes[4] = { 3, 2, 2, 1 };
+            for (uint32_t type = kPositions; type <= kFaces; ++type) {
+                if (counts[type] > file_size / min_bytes[type]) return false;
+            }
+
+            std::vector<const ChunkEntry*> sorted;
+            sorted.reserve(chunks.size());
+            bool has_directives = false;
+            for (const auto& chunk : chunks) {
+                if (chunk.type_ == kDirectives) {
+                    if (header.version_ < kVersion || has_directives || chunk.first_ != 0 || chunk.count_ == 0 ||
+                        chunk.offset_ > file_size || chunk.size_ > file_size - chunk.offset_ ||
+                        chunk.count_ > chunk.size_ / kMinDirectiveBytes) {
+                        return false;
+                    }
+                    has_directives = true;
+                    continue;
+                }
+                if (chunk.type_ > kFaces || chunk.count_ == 0 || chunk.first_ > counts[chunk.type_] ||
+                    chunk.count_ > counts[chunk.type_] - chunk.first_ ||
+                    chunk.offset_ > file_size || chunk.size_ > file_size - chunk.offset_) {
+                    return false;
+                }
+                sorted.push_back(&chunk);
+            }
+            std::sort(sorted.begin(), sorted.end(), [](const ChunkEntry* a, const ChunkEntry* b) {
+                return a->type_ != b->type_ ? a->type_ < b->type_ : a->first_ < b->first_;
+            });
+            uint64_t covered[4] = { 0, 0, 0, 0 };
+            for (const ChunkEntry* chunk : sorted) {
+                if (chunk->first_ != covered[chunk->type_]) return false;
+                covered[chunk->type_] += chunk->count_;
+            }
+            return std::equal(std::begin(covered), std::end(covered), std::begin(counts));
+        }
+
+        size_t RawBytes(const mesh::Mesh& mesh) {
+            size_t corners = 0;
+            for (const auto& face : mesh.faces_) corners += face.vIdx_.size();
+            return mesh.vertices_.size() * sizeof(linear_algebra::Vector3)
+                + mesh.texcoords_.size() * sizeof(linear_algebra::Vector2)
+                + mesh.normals_.size() * sizeof(linear_algebra::Vector3)
+                + mesh.faces_.size() * sizeof(uint32_t)
+                + corners * 3 * sizeof(int)
+                + mesh.groups_.directives().size() * sizeof(mesh::Directive);
+        }
+    }  // namespace
+
+    CQuantizedFile::CQuantizedFile() {
+    }
+
+    bool CQuantizedFile::write(const std::string& file_path) const {
+        std::ofstream out(file_path, std::ios::binary);
+        if (!out.is_open()) {
+            std::cerr << "Failed to write quantized mesh file: " << file_path << "\n";
+            return false;
+        }
+        return write(out);
+    }
+
+    bool CQuantizedFile::write(std::ostream& out) const {
+        if (!IsLittleEndianHost()) {
+            std::cerr << "Quantized mesh I/O requires a little endian host\n";
+            return false;
+        }
+        if (position_bits_ < 1 || position_bits_ > 30) {
+            std::cerr << "Position bit depth must be in [1, 30], got " << position_bits_ << "\n";
+            return false;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        const mesh::Mesh& mesh = *mesh_;
+
+        ContainerHeader header{};
+        std::memcpy(header.magic_, kMagic, sizeof(kMagic));
+        header.version_ = mesh.groups_.empty() ? kVersionNoDirectives : kVersion;
+        header.position_bits_ = position_bits_;
+        header.texcoord_bits_ = texcoord_bits_;
+        header.normal_bits_ = normal_bits_;
+        header.vertex_count_ = mesh.vertices_.size();
+        header.texcoord_count_ = mesh.texcoords_.size();
+        header.normal_count_ = mesh.normals_.size();
+        header.face_count_ = mesh.faces_.size();
+
+        std::fill(std::begin(header.box_min_), std::end(header.box_min_), mesh.vertices_.empty() ? 0.0 : std::numeric_limits<double>::max());
+        std::fill(std::begin(header.box_max_), std::end(header.box_max_), mesh.vertices_.empty() ? 0.0 : std::numeric_limits<double>::lowest());
+        for (const auto& v : mesh.vertices_) {
+            const double xyz[3] = { v.x_, v.y_, v.z_ };
+            for (int k = 0; k < 3; ++k) {
+                header.box_min_[k] = std::min(header.box_min_[k], xyz[k]);
+                header.box_max_[k] = std::max(header.box_max_[k], xyz[k]);
+            }
+        }
+        std::fill(std::begin(header.uv_min_), std::end(header.uv_min_), mesh.texcoords_.empty() ? 0.0 : std::numeric_limits<double>::max());
+        std::fill(std::begin(header.uv_max_), std::end(header.uv_max_), mesh.texcoords_.empty() ? 0.0 : std::numeric_limits<double>::lowest());
+        for (const auto& vt : mesh.texcoords_) {
+            header.uv_min_[0] = std::min(header.uv_min_[0], vt.u_);
+            header.uv_min_[1] = std::min(header.uv_min_[1], vt.v_);
+            header.uv_max_[0] = std::max(header.uv_max_[0], vt.u_);
+            header.uv_max_[1] = std::max(header.uv_max_[1], vt.v_);
+        }
+
+        std::vector<ChunkEntry> chunks;
+        AddChunks(chunks, kPositions, mesh.vertices_.size());
+        AddChunks(chunks, kTexcoords, mesh.texcoords_.size());
+        AddChunks(chunks, kNormals, mesh.normals_.size());
+        AddChunks(chunks, kFaces, mesh.faces_.size());
+        if (!mesh.groups_.empty()) {
+            ChunkEntry entry{};
+            entry.type_ = kDirectives;
+            entry.count_ = mesh.groups_.directives().size();
+            chunks.push_back(entry);
+        }
+        header.chunk_count_ = static_cast<uint32_t>(chunks.size());
+
+        std::vector<ByteWriter> payloads(chunks.size());
+        ParallelFor(chunks.size(), [&](size_t c) {
+            const ChunkEntry& chunk = chunks[c];
+            ByteWriter& w = payloads[c];
+            const size_t end = chunk.first_ + chunk.count_;
+            switch (chunk.type_) {
+            case kPositions: {
+                const Quantizer qx(header.box_min_[0], header.box_max_[0], position_bits_);
+                const Quantizer qy(header.box_min_[1], header.box_max_[1], position_bits_);
+                const Quantizer qz(header.box_min_[2], header.box_max_[2], position_bits_);
+                int64_t prev[3] = { 0, 0, 0 };
+                for (size_t i = chunk.first_; i < end; ++i) {
+                    const auto& v = mesh.vertices_[i];
+                    const int64_t q[3] = { qx.encode(v.x_), qy.encode(v.y_), qz.encode(v.z_) };
+                    for (int k = 0; k < 3; ++k) {
+                        w.zigzag(q[k] - prev[k]);
+                        prev[k] = q[k];
+                    }
+                }
+                break;
+            }
+            case kTexcoords: {
+                const Quantizer qu(header.uv_min_[0], header.uv_max_[0], texcoord_bits_);
+                const Quantizer qv(header.uv_min_[1], header.uv_max_[1], texcoord_bits_);
+                int64_t prev[2] = { 0, 0 };
+                for (size_t i = chunk.first_; i < end; ++i) {
+                    const auto& vt = mesh.texcoords_[i];
+                    const int64_t q[2] = { qu.encode(vt.u_), qv.encode(vt.v_) };
+                    for (int k = 0; k < 2; ++k) {
+                        w.zigzag(q[k] - prev[k]);
+                        prev[k] = q[k];
+                    }
+                }
+                break;
+            }
+            case kNormals: {
+                int64_t prev[2] = { 0, 0 };
+                for (size_t i = chunk.first_; i < end; ++i) {
+                    int64_t q[2];
+                    EncodeOctahedral(mesh.normals_[i], normal_bits_, q);
+                    for (int k = 0; k < 2; ++k) {
+                        w.zigzag(q[k] - prev[k]);
+                        prev[k] = q[k];
+                    }
+                }
+                break;
+            }
+            case kFaces: {
+                int64_t prev_v = 0, prev_vt = 0, prev_vn = 0;
+                for (size_t f = chunk.first_; f < end; ++f) {
+                    const auto& face = mesh.faces_[f];
+                    w.varint(face.vIdx_.size());
+                    for (size_t i = 0; i < face.vIdx_.size(); ++i) {
+                        const int64_t v = face.vIdx_[i];
+                        const int64_t vt = i < face.vtIdx_.size() ? face.vtIdx_[i] : -1;
+                        const int64_t vn = i < face.vnIdx_.size() ? face.vnIdx_[i] : -1;
+                        w.zigzag(v - prev_v);
+                        w.zigzag(vt - prev_vt);
+                        w.zigzag(vn - prev_vn);
+                        prev_v = v;
+                        prev_vt = vt;
+                        prev_vn = vn;
+                    }
+                }
+                break;
+            }
+            case kDirectives: {
+                // names inline, faces delta coded; directives are few next to the faces
+                uint32_t prev_face = 0;
+                for (const auto& directive : mesh.groups_.directives()) {
+                    w.varint(directive.face_ - prev_face);
+                    w.varint(static_cast<uint64_t>(directive.kind_));
+                    w.string(mesh.groups_.name(directive.name_));
+                    prev_face = directive.face_;
+                }
+                break;
+            }
+            }
+        });
+
+        uint64_t offset = sizeof(header) + chunks.size() * sizeof(ChunkEntry);
+        for (size_t c = 0; c < chunks.size(); ++c) {
+            chunks[c].offset_ = offset;
+            chunks[c].size_ = payloads[c].bytes().size();
+            offset += chunks[c].size_;
+        }
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(chunks.data()), chunks.size() * sizeof(ChunkEntry));
+        for (auto& payload : payloads) {
+            out.write(reinterpret_cast<const char*>(payload.bytes().data()), payload.bytes().size());
+        }
+        out.flush();
+
+        stats_.raw_bytes_ = RawBytes(mesh);
+        stats_.encoded_bytes_ = static_cast<size_t>(offset);
+        stats_.seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return static_cast<bool>(out);
+    }
+
+    bool CQuantizedFile::read(const std::string& file_path) {
+        CFileBuffer buffer;
+        if (!buffer.open(file_path)) {
+            std::cerr << "Failed to open quantized mesh file: " << file_path << "\n";
+            return false;
+        }
+        return parse(buffer, file_path);
+    }
+
+    bool CQuantizedFile::read(std::istream& in) {
+        CFileBuffer buffer;
+        if (!buffer.open(in)) {
+            std::cerr << "Failed to read quantized mesh stream\n";
+            return false;
+        }
+        return parse(buffer, "<stream>");
+    }
+
+    bool CQuantizedFile::parse(const CFileBuffer& buffer, const std::string& file_path) {
+        if (!IsLittleEndianHost()) {
+            std::cerr << "Quantized mesh I/O requires a little endian host\n";
+            return false;
+        }
+        const auto start = std::chrono::steady_clock::now();
+
+        ContainerHeader header;
+        if (buffer.size() < sizeof(header)) {
+            std::cerr << "Truncated quantized mesh file: " << file_path << "\n";
+            return false;
+        }
+        std::memcpy(&header, buffer.data(), sizeof(header));
+        if (std::memcmp(header.magic_, kMagic, sizeof(kMagic)) != 0 || (header.version_ != kVersion && header.version_ != kVersionNoDirectives) ||
+            header.position_bits_ < 1 || header.position_bits_ > 30 ||
+            header.texcoord_bits_ < 1 || header.texcoord_bits_ > 30 ||
+            header.normal_bits_ < 2 || header.normal_bits_ > 30) {
+            std::cerr << "Not a quantized mesh file (or unsupported version): " << file_path << "\n";
+            return false;
+        }
+        if (buffer.size() < sizeof(header) + static_cast<size_t>(header.chunk_count_) * sizeof(ChunkEntry)) {
+            std::cerr << "Truncated quantized mesh chunk table: " << file_path << "\n";
+            return false;
+        }
+        std::vector<ChunkEntry> chunks(header.chunk_count_);
+        std::memcpy(chunks.data(), buffer.data() + sizeof(header), chunks.size() * sizeof(ChunkEntry));
+
+        if (!ValidChunkTable(header, chunks, buffer.size())) {
+            std::cerr << "Corrupt quantized mesh chunk table: " << file_path << "\n";
+            return false;
+        }
+
+        *mesh_ = mesh::Mesh();
+        mesh::Mesh& mesh = *mesh_;
+        mesh.vertices_.resize(header.vertex_count_);
+        mesh.texcoords_.resize(header.texcoord_count_);
+        mesh.normals_.resize(header.normal_count_);
+        mesh.faces_.resize(header.face_count_);
+
+        std::atomic<bool> ok(true);
+        const uint8_t* base = reinterpret_cast<const uint8_t*>(buffer.data());
+        ParallelFor(chunks.size(), [&](size_t c) {
+            const ChunkEntry& chunk = chunks[c];
+            ByteReader r(base + chunk.offset_, base + chunk.offset_ + chunk.size_);
+            const size_t end = chunk.first_ + chunk.count_;
+            switch (chunk.type_) {
+            case kPositions: {
+                const Quantizer qx(header.box_min_[0], header.box_max_[0], header.position_bits_);
+                const Quantizer qy(header.box_min_[1], header.box_max_[1], header.position_bits_);
+                const Quantizer qz(header.box_min_[2], header.box_max_[2], header.position_bits_);
+                int64_t q[3] = { 0, 0, 0 };
+                for (size_t i = chunk.first_; i < end; ++i) {
+                    for (int k = 0; k < 3; ++k) q[k] += r.zigzag();
+                    mesh.vertices_[i] = { qx.decode(q[0]), qy.decode(q[1]), qz.decode(q[2]) };
+                }
+                break;
+            }
+            case kTexcoords: {
+                const Quantizer qu(header.uv_min_[0], header.uv_max_[0], header.texcoord_bits_);
+                const Quantizer qv(header.uv_min_[1], header.uv_max_[1], header.texcoord_bits_);
+                int64_t q[2] = { 0, 0 };
+                for (size_t i = chunk.first_; i < end; ++i) {
+                    for (int k = 0; k < 2; ++k) q[k] += r.zigzag();
+                    mesh.texcoords_[i] = { qu.decode(q[0]), qv.decode(q[1]) };
+                }
+                break;
+            }
+            case kNormals: {
+                int64_t q[2] = { 0, 0 };
+                for (size_t i = chunk.first_; i < end; ++i) {
+                    for (int k = 0; k < 2; ++k) q[k] += r.zigzag();
+                    mesh.normals_[i] = DecodeOctahedral(q, header.normal_bits_);
+                }
+                break;
+            }
+            case kFaces: {
+                int64_t v = 0, vt = 0, vn = 0;
+                for (size_t f = chunk.first_; f < end && r.ok(); ++f) {
+                    const uint64_t count = r.varint();
+                    if (count > chunk.size_) {
+                        ok = false;
+                        return;
+                    }
+                    mesh::Face& face = mesh.faces_[f];
+                    face.vIdx_.resize(count);
+                    face.vtIdx_.resize(count);
+                    face.vnIdx_.resize(count);
+                    for (size_t i = 0; i < count; ++i) {
+                        v += r.zigzag();
+                        vt += r.zigzag();
+                        vn += r.zigzag();
+                        face.vIdx_[i] = static_cast<int>(v);
+                        face.vtIdx_[i] = static_cast<int>(vt);
+                        face.vnIdx_[i] = static_cast<int>(vn);
+                    }
+                }
+                break;
+            }
+            case kDirectives: {
+                // the only chunk touching groups_, so it needs no lock
+                uint64_t face = 0;
+                std::string name;
+                for (size_t i = 0; i < chunk.count_ && r.ok(); ++i) {
+                    const uint64_t delta = r.varint();
+                    const uint64_t kind = r.varint();
+                    if (!r.string(name) || delta > header.face_count_ - face ||
+                        kind > static_cast<uint64_t>(mesh::DirectiveKind::kSmoothing)) {
+                        ok = false;
+                        return;
+                    }
+                    face += delta;
+                    mesh.groups_.add(static_cast<mesh::DirectiveKind>(kind), name, static_cast<uint32_t>(face));
+                }
+                break;
+            }
+            }
+            if (!r.ok()) ok = false;
+        });
+
+        if (!ok) {
+            std::cerr << "Corrupt quantized mesh payload: " << file_path << "\n";
+            return false;
+        }
+
+        stats_.raw_bytes_ = RawBytes(mesh);
+        stats_.encoded_bytes_ = buffer.size();
+        stats_.seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return true;
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef QUANTIZED_FILE_H_
+#define QUANTIZED_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+#include "mesh_file.h"
+
+namespace file {
+	// size and timing of the last encode / decode
+	struct CodecStats {
+		size_t raw_bytes_ = 0;      // in-memory size of the mesh arrays and indices
+		size_t encoded_bytes_ = 0;  // size of the container
+		double seconds_ = 0.0;
+	};
+
+	// Quantized, chunked mesh container (.qmesh):
+	//  - positions quantized to position_bits per axis inside the mesh AABB
+	//  - texcoords to fixed point inside their bounding rectangle
+	//  - normals octahedral encoded, normal_bits per component
+	//  - every stream delta + zigzag + varint coded
+	//  - OBJ directives (mtllib / o / g / usemtl / s) in one extra chunk
+	// Attributes and faces are split into chunks that encode and decode
+	// independently, one chunk per worker thread.
+	class CQuantizedFile : public CMeshFileBase<CQuantizedFile, MeshFormat::kQuantized> {
+	public:
+		explicit CQuantizedFile();
+
+		bool read(const std::string& file_path) override;
+		bool read(std::istream& in) override;
+		bool write(const std::string& file_path) const override;
+		bool write(std::ostream& out) const override;
+
+		void set_position_bits(int bits) { position_bits_ = bits; }
+		int position_bits() const { return position_bits_; }
+
+		const CodecStats& last_stats() const { return stats_; }
+
+	private:
+		bool parse(const CFileBuffer& buffer, const std::string& file_path);
+
+		int position_bits_ = 16;
+		int texcoord_bits_ = 16;
+		int normal_bits_ = 12;
+		mutable CodecStats stats_;
+	};
+}
+
+#endif // QUANTIZED_FILE_H_
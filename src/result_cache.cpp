@@ -0,0 +1,326 @@
+#include "result_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <system_error>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/file.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/clonefile.h>
+#include <sys/file.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <process.h>
+#include <share.h>
+#include <sys/locking.h>
+#include <sys/stat.h>
+#endif
+
+#include "file_buffer.h"
+
+namespace mesh_app {
+    namespace fs = std::filesystem;
+
+    namespace {
+        // bump when the bytes written for the same job change (encoder, writer or stage fixes)
+        constexpr uint32_t kKeySchema = 2;
+
+        // staging files of runs that died before their rename; a live copy is much younger
+        constexpr std::chrono::hours kStaleStagingAge(1);
+
+        constexpr uint64_t kPrime1 = 11400714785074694791ull;
+        constexpr uint64_t kPrime2 = 14029467366897019727ull;
+        constexpr uint64_t kPrime3 = 1609587929392839161ull;
+        constexpr uint64_t kPrime4 = 9650029242287828579ull;
+        constexpr uint64_t kPrime5 = 2870177450012600261ull;
+
+        uint64_t Rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+        uint64_t Load64(const unsigned char* p) {
+            uint64_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        uint32_t Load32(const unsigned char* p) {
+            uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        uint64_t Round(uint64_t acc, uint64_t input) {
+            acc += input * kPrime2;
+            acc = Rotl(acc, 31);
+            return acc * kPrime1;
+        }
+
+        uint64_t MergeRound(uint64_t acc, uint64_t value) {
+            acc ^= Round(0, value);
+            return acc * kPrime1 + kPrime4;
+        }
+
+        template <typename T>
+        void Append(std::string& bytes, const T& value) {
+            bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        std::string Hex64(uint64_t value) {
+            char text[17];
+            std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(value));
+            return text;
+        }
+
+        int ProcessId() {
+#ifdef _WIN32
+            return _getpid();
+#else
+            return static_cast<int>(getpid());
+#endif
+        }
+
+        // copy-on-write clone where the filesystem has one, otherwise a plain copy
+        bool CloneOrCopy(const std::string& from, const std::string& to) {
+            std::error_code ec;
+#if defined(__linux__) && defined(FICLONE)
+            const int src = ::open(from.c_str(), O_RDONLY);
+            if (src >= 0) {
+                const int dst = ::open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+                const bool cloned = dst >= 0 && ::ioctl(dst, FICLONE, src) == 0;
+                if (dst >= 0) ::close(dst);
+                ::close(src);
+                if (cloned) return true;
+            }
+#elif defined(__APPLE__)
+            fs::remove(to, ec);
+            if (::clonefile(from.c_str(), to.c_str(), 0) == 0) return true;
+#endif
+            return fs::copy_file(from, to, fs::copy_options::overwrite_existing, ec) && !ec;
+        }
+
+        // replace the text of path by update(text) under an exclusive lock, so concurrent
+        // runs never lose each other's changes; false when the file cannot be locked
+        bool UpdateLocked(const std::string& path, const std::function<std::string(const std::string&)>& update) {
+            std::string text;
+            char chunk[256];
+#if defined(__linux__) || defined(__APPLE__)
+            const int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+            if (fd < 0) return false;
+            bool ok = ::flock(fd, LOCK_EX) == 0;  // released by close
+            if (ok) {
+                ssize_t n;
+                while ((n = ::read(fd, chunk, sizeof(chunk))) > 0) text.append(chunk, static_cast<size_t>(n));
+                const std::string updated = n == 0 ? update(text) : std::string();
+                ok = n == 0 && ::ftruncate(fd, 0) == 0 &&
+                    ::pwrite(fd, updated.data(), updated.size(), 0) == static_cast<ssize_t>(updated.size());
+            }
+            ::close(fd);
+            return ok;
+#elif defined(_WIN32)
+            int fd = -1;
+            if (_sopen_s(&fd, path.c_str(), _O_RDWR | _O_CREAT | _O_BINARY, _SH_DENYNO, _S_IREAD | _S_IWRITE) != 0) {
+                return false;
+            }
+            bool ok = _locking(fd, _LK_LOCK, 1) == 0;  // byte 0; _LK_LOCK retries for about 10 s
+            if (ok) {
+                int n;
+                while ((n = _read(fd, chunk, sizeof(chunk))) > 0) text.append(chunk, static_cast<size_t>(n));
+                const std::string updated = n == 0 ? update(text) : std::string();
+                ok = n == 0 && _chsize_s(fd, 0) == 0 && _lseek(fd, 0, SEEK_SET) == 0 &&
+                    _write(fd, updated.data(), static_cast<unsigned>(updated.size())) == static_cast<int>(updated.size());
+                _lseek(fd, 0, SEEK_SET);
+                _locking(fd, _LK_UNLCK, 1);
+            }
+            _close(fd);
+            return ok;
+#else
+            // no portable file lock here: concurrent runs may drop counts
+            {
+                std::ifstream in(path, std::ios::binary);
+                text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            }
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out << update(text);
+            return static_cast<bool>(out);
+#endif
+        }
+    }  // namespace
+
+    uint64_t Hash64(const void* data, size_t size, uint64_t seed) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        const unsigned char* const end = p + size;
+        uint64_t h;
+
+        if (size >= 32) {
+            uint64_t v1 = seed + kPrime1 + kPrime2;
+            uint64_t v2 = seed + kPrime2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - kPrime1;
+            const unsigned char* const limit = end - 32;
+            do {
+                v1 = Round(v1, Load64(p));
+                v2 = Round(v2, Load64(p + 8));
+                v3 = Round(v3, Load64(p + 16));
+                v4 = Round(v4, Load64(p + 24));
+                p += 32;
+            } while (p <= limit);
+            h = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+            h = MergeRound(h, v1);
+            h = MergeRound(h, v2);
+            h = MergeRound(h, v3);
+            h = MergeRound(h, v4);
+        }
+        else {
+            h = seed + kPrime5;
+        }
+        h += static_cast<uint64_t>(size);
+
+        for (; p + 8 <= end; p += 8) {
+            h ^= Round(0, Load64(p));
+            h = Rotl(h, 27) * kPrime1 + kPrime4;
+        }
+        if (p + 4 <= end) {
+            h ^= static_cast<uint64_t>(Load32(p)) * kPrime1;
+            h = Rotl(h, 23) * kPrime2 + kPrime3;
+            p += 4;
+        }
+        for (; p < end; ++p) {
+            h ^= (*p) * kPrime5;
+            h = Rotl(h, 11) * kPrime1;
+        }
+
+        h ^= h >> 33;
+        h *= kPrime2;
+        h ^= h >> 29;
+        h *= kPrime3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    ResultCache::ResultCache(std::string dir, uint64_t max_bytes)
+        : dir_(std::move(dir)), max_bytes_(max_bytes) {}
+
+    std::string ResultCache::entry_path(const std::string& key) const {
+        return (fs::path(dir_) / (key + ".result")).string();
+    }
+
+    bool ResultCache::make_key(const std::string& input_path, file::MeshFormat input_format,
+        file::MeshFormat output_format, const JobOptions& options, std::string& key) const {
+        std::error_code ec;
+        fs::create_directories(dir_, ec);
+        if (ec) return false;
+
+        // canonical job: the stages as the CLI runs them, matrices by bit pattern
+        std::string job;
+        Append(job, kKeySchema);
+        Append(job, static_cast<int32_t>(input_format));
+        Append(job, static_cast<int32_t>(output_format));
+        if (output_format == file::MeshFormat::kQuantized) {
+            Append(job, static_cast<int32_t>(options.quant_bits_));
+        }
+        for (const auto& stage : options.stages_) {
+            Append(job, static_cast<int32_t>(stage.kind_));
+            Append(job, static_cast<uint32_t>(stage.group_.size()));
+            job += stage.group_;
+            if (stage.kind_ == JobStage::Kind::kTransform) {
+                for (double value : stage.matrix_.data()) Append(job, value + 0.0);
+            }
+            else {
+                Append(job, stage.value_ + 0.0);
+                if (stage.max_mb_) Append(job, static_cast<uint64_t>(stage.max_mb_));
+            }
+        }
+
+        file::CFileBuffer input;
+        if (!input.open(input_path)) return false;
+        const uint64_t job_hash = Hash64(job.data(), job.size());
+        key = Hex64(Hash64(input.data(), input.size(), job_hash));
+        return true;
+    }
+
+    bool ResultCache::fetch(const std::string& key, const std::string& output_path) const {
+        const std::string entry = entry_path(key);
+        std::error_code ec;
+        if (!fs::is_regular_file(entry, ec)) return false;
+        if (!CloneOrCopy(entry, output_path)) return false;
+        fs::last_write_time(entry, fs::file_time_type::clock::now(), ec);
+        return true;
+    }
+
+    bool ResultCache::store(const std::string& key, const std::string& output_path) const {
+        // write beside the entry and rename, so concurrent runs never see a partial result
+        const std::string entry = entry_path(key);
+        const std::string staging = entry + ".tmp" + std::to_string(ProcessId());
+        std::error_code ec;
+        if (!CloneOrCopy(output_path, staging)) {
+            fs::remove(staging, ec);
+            return false;
+        }
+        fs::rename(staging, entry, ec);
+        if (ec) {
+            fs::remove(staging, ec);
+            return false;
+        }
+
+        struct Entry {
+            fs::path path_;
+            fs::file_time_type mtime_;
+            uint64_t size_;
+        };
+        std::vector<Entry> entries;
+        uint64_t total = 0;
+        const auto now = fs::file_time_type::clock::now();
+        for (const auto& item : fs::directory_iterator(dir_, ec)) {
+            if (!item.is_regular_file(ec)) continue;
+            if (item.path().filename().string().find(".result.tmp") != std::string::npos) {
+                const auto mtime = item.last_write_time(ec);
+                if (!ec && now - mtime > kStaleStagingAge) fs::remove(item.path(), ec);
+                continue;
+            }
+            if (item.path().extension() != ".result") continue;
+            const uint64_t size = item.file_size(ec);
+            if (ec) continue;
+            entries.push_back({ item.path(), item.last_write_time(ec), size });
+            total += size;
+        }
+        std::sort(entries.begin(), entries.end(),
+            [](const Entry& a, const Entry& b) { return a.mtime_ < b.mtime_; });
+        for (const auto& old : entries) {
+            if (total <= max_bytes_) break;
+            if (old.path_ == fs::path(entry)) continue;
+            if (fs::remove(old.path_, ec)) total -= old.size_;
+        }
+        return true;
+    }
+
+    void ResultCache::count(bool hit, uint64_t& hits, uint64_t& misses) const {
+        const std::string stats_path = (fs::path(dir_) / "stats").string();
+        hits = misses = 0;
+        UpdateLocked(stats_path, [&](const std::string& text) {
+            std::istringstream in(text);
+            in >> hits >> misses;
+            if (!in) hits = misses = 0;
+            if (hit) {
+                ++hits;
+            }
+            else {
+                ++misses;
+            }
+            return std::to_string(hits) + " " + std::to_string(misses) + "\n";
+        });
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef MESH_APP_RESULT_CACHE_H_
+#define MESH_APP_RESULT_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "mesh_file.h"
+#include "transform_options.h"
+
+namespace mesh_app {
+	// XXH64 of size bytes at data
+	uint64_t Hash64(const void* data, size_t size, uint64_t seed = 0);
+
+	// Finished outputs under <dir>/<key>.result, keyed by the input bytes plus the canonical
+	// job (formats, composed stage matrices, stage values, .qmesh quantization). Entries are
+	// immutable; a hit refreshes the entry mtime and eviction drops the oldest mtimes
+	// until the directory holds at most max_bytes of results.
+	class ResultCache {
+	public:
+		ResultCache(std::string dir, uint64_t max_bytes);
+
+		// false when the input cannot be read or the cache directory cannot be created
+		bool make_key(const std::string& input_path, file::MeshFormat input_format,
+			file::MeshFormat output_format, const JobOptions& options, std::string& key) const;
+
+		// true when output_path now holds the cached result (reflink where supported, else copy)
+		bool fetch(const std::string& key, const std::string& output_path) const;
+
+		// add a finished output, then evict the oldest entries down to max_bytes (never this one)
+		// and remove staging files left an hour or more by runs that died mid-store
+		bool store(const std::string& key, const std::string& output_path) const;
+
+		// count this run in <dir>/stats under a file lock and return the totals (zero when
+		// the stats file cannot be locked)
+		void count(bool hit, uint64_t& hits, uint64_t& misses) const;
+
+	private:
+		std::string entry_path(const std::string& key) const;
+
+		std::string dir_;
+		uint64_t max_bytes_;
+	};
+}
+
+#endif // MESH_APP_RESULT_CACHE_H_
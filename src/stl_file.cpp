@@ -0,0 +1,138 @@
+#include "stl_file.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "file_buffer.h"
+#include "mesh/mesh.h"
+
+namespace file {
+    namespace {
+        constexpr size_t kHeaderSize = 80;
+        constexpr size_t kTriangleSize = 50;  // normal + 3 vertices as float32, uint16 attribute
+
+        char* StoreVector(char* p, const linear_algebra::Vector3& v) {
+            const float xyz[3] = { static_cast<float>(v.x_), static_cast<float>(v.y_), static_cast<float>(v.z_) };
+            std::memcpy(p, xyz, sizeof(xyz));
+            return p + sizeof(xyz);
+        }
+
+        linear_algebra::Vector3 LoadVector(const char* p) {
+            float xyz[3];
+            std::memcpy(xyz, p, sizeof(xyz));
+            return { xyz[0], xyz[1], xyz[2] };
+        }
+    }  // namespace
+
+    CStlFile::CStlFile() {
+    }
+
+    bool CStlFile::read(const std::string& stl_file_path) {
+        CFileBuffer buffer;
+        if (!buffer.open(stl_file_path)) {
+            std::cerr << "Failed to open STL file: " << stl_file_path << "\n";
+            return false;
+        }
+        return parse(buffer, stl_file_path);
+    }
+
+    bool CStlFile::read(std::istream& in) {
+        CFileBuffer buffer;
+        if (!buffer.open(in)) {
+            std::cerr << "Failed to read STL stream\n";
+            return false;
+        }
+        return parse(buffer, "<stream>");
+    }
+
+    bool CStlFile::parse(const CFileBuffer& buffer, const std::string& stl_file_path) {
+        if (!IsLittleEndianHost()) {
+            std::cerr << "STL I/O requires a little endian host\n";
+            return false;
+        }
+
+        uint32_t count = 0;
+        if (buffer.size() >= kHeaderSize + sizeof(count)) {
+            std::memcpy(&count, buffer.data() + kHeaderSize, sizeof(count));
+        }
+        if (buffer.size() < kHeaderSize + sizeof(count) ||
+            buffer.size() != kHeaderSize + sizeof(count) + static_cast<size_t>(count) * kTriangleSize) {
+            std::cerr << "Not a binary STL file (ASCII STL is not supported): " << stl_file_path << "\n";
+            return false;
+        }
+
+        *mesh_ = mesh::Mesh();
+        mesh_->vertices_.resize(static_cast<size_t>(count) * 3);
+        mesh_->normals_.resize(count);
+        mesh_->faces_.resize(count);
+
+        const char* p = buffer.data() + kHeaderSize + sizeof(count);
+        for (uint32_t t = 0; t < count; ++t, p += kTriangleSize) {
+            const int base = static_cast<int>(t) * 3;
+            linear_algebra::Vector3* corners = &mesh_->vertices_[base];
+            corners[0] = LoadVector(p + 12);
+            corners[1] = LoadVector(p + 24);
+            corners[2] = LoadVector(p + 36);
+
+            linear_algebra::Vector3 normal = LoadVector(p);
+            if (normal.dot(normal) == 0.0) {
+                normal = (corners[1] - corners[0]).cross(corners[2] - corners[0]).normalized();
+            }
+            mesh_->normals_[t] = normal;
+
+            mesh::Face& face = mesh_->faces_[t];
+            face.vIdx_ = { base, base + 1, base + 2 };
+            face.vtIdx_ = { -1, -1, -1 };
+            face.vnIdx_ = { static_cast<int>(t), static_cast<int>(t), static_cast<int>(t) };
+        }
+        return true;
+    }
+
+    bool CStlFile::write(const std::string& stl_file_path) const {
+        std::ofstream out(stl_file_path, std::ios::binary);
+        if (!out.is_open()) {
+            std::cerr << "Failed to write STL file: " << stl_file_path << "\n";
+            return false;
+        }
+        return write(out);
+    }
+
+    bool CStlFile::write(std::ostream& out) const {
+        if (!IsLittleEndianHost()) {
+            std::cerr << "STL I/O requires a little endian host\n";
+            return false;
+        }
+
+        const mesh::Mesh& mesh = *mesh_;
+        const std::vector<const mesh::Face*> faces = WritableFaces(mesh, "STL");
+        size_t triangles = 0;
+        for (const mesh::Face* face : faces) {
+            if (face->vIdx_.size() >= 3) triangles += face->vIdx_.size() - 2;
+        }
+        const uint32_t count = static_cast<uint32_t>(triangles);
+        std::vector<char> block(kHeaderSize + sizeof(count) + static_cast<size_t>(count) * kTriangleSize, 0);
+        static const char kHeader[] = "binary STL written by MeshTransform";
+        std::memcpy(block.data(), kHeader, sizeof(kHeader));
+        std::memcpy(block.data() + kHeaderSize, &count, sizeof(count));
+
+        char* p = block.data() + kHeaderSize + sizeof(count);
+        for (const mesh::Face* face : faces) {
+            const auto& idx = face->vIdx_;
+            for (size_t i = 1; i + 1 < idx.size(); ++i) {
+                const linear_algebra::Vector3& a = mesh.vertices_[idx[0]];
+                const linear_algebra::Vector3& b = mesh.vertices_[idx[i]];
+                const linear_algebra::Vector3& c = mesh.vertices_[idx[i + 1]];
+                p = StoreVector(p, (b - a).cross(c - a).normalized());
+                p = StoreVector(p, a);
+                p = StoreVector(p, b);
+                p = StoreVector(p, c);
+                p += sizeof(uint16_t);
+            }
+        }
+        out.write(block.data(), block.size());
+        return static_cast<bool>(out);
+    }
+}
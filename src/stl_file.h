@@ -0,0 +1,25 @@
+#ifndef STL_FILE_H_
+#define STL_FILE_H_
+
+#include <string>
+
+#include "mesh_file.h"
+
+namespace file {
+	// binary STL. triangles are not welded on read: every facet owns three
+	// vertices and one normal. polygons are fan triangulated on write.
+	class CStlFile : public CMeshFileBase<CStlFile, MeshFormat::kStl> {
+	public:
+		explicit CStlFile();
+
+		bool read(const std::string& stl_file_path) override;
+		bool read(std::istream& in) override;
+		bool write(const std::string& stl_file_path) const override;
+		bool write(std::ostream& out) const override;
+
+	private:
+		bool parse(const CFileBuffer& buffer, const std::string& stl_file_path);
+	};
+}
+
+#endif // STL_FILE_H_
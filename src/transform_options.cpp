@@ -0,0 +1,255 @@
+#include "transform_options.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <stdexcept>
+#include <sstream>
+#ifdef _MSC_VER
+#include <corecrt_math_defines.h>
+#endif
+
+#include "mesh/mesh.h"
+
+namespace mesh_app {
+    using linear_algebra::Matrix4x4;
+
+    double DegToRad(double deg) { return deg * M_PI / 180.0; }
+
+    bool ParseTransformOption(const std::vector<std::string>& args, size_t& i,
+        Matrix4x4& op, std::string& label) {
+        const std::string& arg = args[i];
+        auto has = [&](size_t n) { return i + n < args.size(); };
+        auto next = [&]() { return std::stod(args[++i]); };
+        std::ostringstream text;
+
+        if (arg == "--translate" && has(3)) {
+            const double tx = next(), ty = next(), tz = next();
+            text << "Translate (" << tx << ", " << ty << ", " << tz << ")";
+            op = Matrix4x4::Translate(tx, ty, tz);
+        }
+        else if (arg == "--scale" && has(1)) {
+            const double s = next();
+            text << "Scale (" << s << ")";
+            op = Matrix4x4::Scale(s);
+        }
+        else if (arg == "--scale-nonuniform" && has(3)) {
+            const double sx = next(), sy = next(), sz = next();
+            text << "ScaleNonUniform (" << sx << ", " << sy << ", " << sz << ")";
+            op = Matrix4x4::ScaleNonUniform(sx, sy, sz);
+        }
+        else if (arg == "--rotate-x" && has(1)) {
+            const double angle = DegToRad(next());
+            text << "RotateX (" << angle << " rad)";
+            op = Matrix4x4::RotateX(angle);
+        }
+        else if (arg == "--rotate-y" && has(1)) {
+            const double angle = DegToRad(next());
+            text << "RotateY (" << angle << " rad)";
+            op = Matrix4x4::RotateY(angle);
+        }
+        else if (arg == "--rotate-z" && has(1)) {
+            const double angle = DegToRad(next());
+            text << "RotateZ (" << angle << " rad)";
+            op = Matrix4x4::RotateZ(angle);
+        }
+        else if (arg == "--rotate-axis" && has(4)) {
+            const double ax = next(), ay = next(), az = next();
+            const double angle = DegToRad(next());
+            text << "RotateAxis axis=(" << ax << ", " << ay << ", " << az << "), angle=" << angle << " rad";
+            op = Matrix4x4::RotateAroundAxis(linear_algebra::Vector3(ax, ay, az), angle);
+        }
+        else if (arg == "--shear" && has(6)) {
+            const double sxy = next(), sxz = next(), syx = next();
+            const double syz = next(), szx = next(), szy = next();
+            text << "Shear (" << sxy << ", " << sxz << ", " << syx << ", "
+                << syz << ", " << szx << ", " << szy << ")";
+            op = Matrix4x4::Shear(sxy, sxz, syx, syz, szx, szy);
+        }
+        else {
+            return false;
+        }
+        label = text.str();
+        return true;
+    }
+
+    bool ParseStageOption(const std::vector<std::string>& args, size_t& i, JobStage& stage) {
+        const std::string& arg = args[i];
+        stage = JobStage();
+        if (arg == "--weld") {
+            stage.kind_ = JobStage::Kind::kWeld;
+            // optional epsilon: taken only when the next argument is a number
+            if (i + 1 < args.size()) {
+                const char* text = args[i + 1].c_str();
+                char* end = nullptr;
+                const double epsilon = std::strtod(text, &end);
+                if (end != text && *end == '\0') {
+                    if (epsilon < 0.0) throw std::invalid_argument("weld epsilon must not be negative");
+                    stage.value_ = epsilon;
+                    ++i;
+                }
+            }
+        }
+        else if (arg == "--recompute-normals") {
+            stage.kind_ = JobStage::Kind::kRecomputeNormals;
+        }
+        else if (arg == "--optimize-order") {
+            stage.kind_ = JobStage::Kind::kOptimizeOrder;
+        }
+        else if (arg == "--decimate" && i + 1 < args.size()) {
+            stage.kind_ = JobStage::Kind::kDecimate;
+            stage.value_ = std::stod(args[++i]);
+            if (stage.value_ <= 0.0) throw std::invalid_argument("decimation target must be positive");
+            // optional working memory cap in MB, same rule as the weld epsilon
+            if (i + 1 < args.size()) {
+                const char* text = args[i + 1].c_str();
+                char* end = nullptr;
+                const unsigned long long max_mb = std::strtoull(text, &end, 10);
+                if (end != text && *end == '\0') {
+                    if (max_mb == 0) throw std::invalid_argument("decimation memory cap must be positive");
+                    stage.max_mb_ = static_cast<size_t>(max_mb);
+                    ++i;
+                }
+            }
+        }
+        else {
+            return false;
+        }
+        return true;
+    }
+
+    bool ParseJobOptions(const std::vector<std::string>& args, JobOptions& options, std::string& error) {
+        options = JobOptions();
+        std::string scope;
+        Matrix4x4 pending;
+        // the CLI's apply_scope: a group block always runs (it may detach shared normals),
+        // a whole-mesh block only when it moves something
+        auto close_scope = [&]() {
+            if (!scope.empty() || pending.data() != Matrix4x4::Identity().data()) {
+                options.stages_.emplace_back();
+                options.stages_.back().group_ = scope;
+                options.stages_.back().matrix_ = pending;
+            }
+            pending = Matrix4x4();
+        };
+        for (size_t i = 0; i < args.size(); ++i) {
+            const std::string& arg = args[i];
+            try {
+                Matrix4x4 op;
+                std::string label;
+                JobStage stage;
+                if (ParseTransformOption(args, i, op, label)) {
+                    pending = op * pending;
+                }
+                else if (ParseStageOption(args, i, stage)) {
+                    close_scope();
+                    options.stages_.push_back(stage);
+                }
+                else if (arg == "--group" && i + 1 < args.size()) {
+                    close_scope();
+                    scope = args[++i];
+                }
+                else if (arg == "--all") {
+                    close_scope();
+                    scope.clear();
+                }
+                else if (arg == "--quant-bits" && i + 1 < args.size()) {
+                    options.quant_bits_ = std::stoi(args[++i]);
+                    if (options.quant_bits_ < 1 || options.quant_bits_ > 30) {
+                        error = "bit depth must be in [1, 30]";
+                        return false;
+                    }
+                }
+                else {
+                    error = "unknown or malformed option: " + arg;
+                    return false;
+                }
+            }
+            catch (const std::exception& e) {
+                error = "bad argument for " + arg + ": " + e.what();
+                return false;
+            }
+        }
+        // the CLI ends with the whole-mesh matrix applied unconditionally, identity included
+        if (scope.empty()) {
+            options.stages_.emplace_back();
+            options.stages_.back().matrix_ = pending;
+        }
+        else {
+            close_scope();
+        }
+        return true;
+    }
+
+    bool ApplyJobStage(mesh::Mesh& mesh, const JobStage& stage, std::string& report, std::string& error) {
+        std::ostringstream text;
+        switch (stage.kind_) {
+        case JobStage::Kind::kTransform:
+            if (stage.group_.empty()) {
+                mesh.apply_transform(stage.matrix_);
+            }
+            else {
+                const mesh::VertexSelection* selection = mesh.select_group(stage.group_);
+                if (!selection) {
+                    error = "no o/g group named '" + stage.group_ + "'";
+                    return false;
+                }
+                mesh.apply_transform(stage.matrix_, *selection);
+            }
+            break;
+        case JobStage::Kind::kWeld: {
+            const size_t before = mesh.vertices().size();
+            const size_t faces = mesh.faces_.size();
+            const size_t merged = mesh.weld(stage.value_);
+            text << "[Weld] epsilon " << stage.value_ << ": merged " << merged << " of " << before
+                << " vertices, dropped " << (faces - mesh.faces_.size()) << " degenerate faces\n";
+            break;
+        }
+        case JobStage::Kind::kRecomputeNormals:
+            mesh.recompute_normals();
+            text << "[Normals] recomputed " << mesh.normals_.size() << " area weighted vertex normals\n";
+            break;
+        case JobStage::Kind::kDecimate: {
+            const size_t before = mesh.triangle_count();
+            const size_t target = stage.value_ <= 1.0
+                ? static_cast<size_t>(before * stage.value_)
+                : static_cast<size_t>(stage.value_);
+            const auto start = std::chrono::steady_clock::now();
+            const size_t after = mesh.decimate(target, stage.max_mb_ << 20);
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            text << "[Decimate] " << before << " -> " << after << " triangles (target " << target
+                << ", " << mesh.vertices().size() << " vertices, " << seconds << " s";
+            if (stage.max_mb_) text << ", " << stage.max_mb_ << " MB working memory cap";
+            text << ")\n";
+            if (after > target) {
+                text << "  stopped above the target: seams, non-manifold edges and isolated triangles are"
+                    " kept (weld a triangle soup such as STL first)\n";
+            }
+            break;
+        }
+        case JobStage::Kind::kOptimizeOrder: {
+            const mesh::VertexCacheStats before = mesh.analyze_vertex_cache();
+            mesh.optimize_vertex_cache();
+            mesh.optimize_vertex_fetch();
+            const mesh::VertexCacheStats after = mesh.analyze_vertex_cache();
+            text << std::fixed << std::setprecision(4)
+                << "=== Vertex Cache Optimization (cache size " << mesh::kDefaultVertexCacheSize << ") ===\n"
+                << "  before: ACMR=" << before.acmr_ << " ATVR=" << before.atvr_ << "\n"
+                << "  after : ACMR=" << after.acmr_ << " ATVR=" << after.atvr_ << "\n";
+            break;
+        }
+        }
+        report = text.str();
+        return true;
+    }
+
+    bool ApplyJobOptions(mesh::Mesh& mesh, const JobOptions& options, std::string& error) {
+        std::string report;
+        for (const auto& stage : options.stages_) {
+            if (!ApplyJobStage(mesh, stage, report, error)) return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef MESH_APP_TRANSFORM_OPTIONS_H_
+#define MESH_APP_TRANSFORM_OPTIONS_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "mesh/transform.h"
+
+namespace mesh {
+	class Mesh;
+}
+
+namespace mesh_app {
+	// degrees → radians
+	double DegToRad(double deg);
+
+	// Matrix option at args[i] (--translate, --scale, --rotate-x, ...). On success i is left on
+	// the option's last argument, op holds the option matrix and label a readable description.
+	// false when args[i] is not a matrix option or misses arguments; bad numbers throw.
+	bool ParseTransformOption(const std::vector<std::string>& args, size_t& i,
+		linear_algebra::Matrix4x4& op, std::string& label);
+
+	// one step of a job, run in command line order
+	struct JobStage {
+		enum class Kind { kTransform, kWeld, kRecomputeNormals, kDecimate, kOptimizeOrder };
+		Kind kind_ = Kind::kTransform;
+		std::string group_;                  // kTransform: o/g scope, empty for the whole mesh
+		linear_algebra::Matrix4x4 matrix_;   // kTransform
+		double value_ = 0.0;                 // kWeld epsilon, kDecimate ratio (<= 1) or triangle count
+		size_t max_mb_ = 0;                  // kDecimate working memory cap, 0 for none
+	};
+
+	// a transform chain in CLI option syntax, as run by --serve jobs
+	struct JobOptions {
+		std::vector<JobStage> stages_;
+		int quant_bits_ = 16;
+	};
+
+	// Mesh stage option at args[i] (--weld [eps], --recompute-normals, --decimate <target> [max-mb],
+	// --optimize-order).
+	// Same contract as ParseTransformOption; invalid values throw.
+	bool ParseStageOption(const std::vector<std::string>& args, size_t& i, JobStage& stage);
+
+	// matrix and stage options, --group, --all and --quant-bits, split into the steps the CLI
+	// runs: matrix options compose until the next --group, --all or mesh stage closes them
+	// (a group block is kept even without matrices, a whole-mesh one only when not identity),
+	// and a job that ends outside any group ends with a whole-mesh stage, identity included
+	bool ParseJobOptions(const std::vector<std::string>& args, JobOptions& options, std::string& error);
+
+	// run one stage; a summary for the log goes to report
+	bool ApplyJobStage(mesh::Mesh& mesh, const JobStage& stage, std::string& report, std::string& error);
+
+	// every stage in order
+	bool ApplyJobOptions(mesh::Mesh& mesh, const JobOptions& options, std::string& error);
+}
+
+#endif // MESH_APP_TRANSFORM_OPTIONS_H_